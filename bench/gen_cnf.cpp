@@ -0,0 +1,90 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+
+/*-------------------------------------------------------------------------+
+ | Command line front end of the formula generators in 'generate.h'.       |
+ | Usage: gen_cnf <family> <size> [seed] [key=value ...]  (to stdout)      |
+ |        gen_cnf --suite <dir> [seed]  (all families at several sizes)    |
+/*-------------------------------------------------------------------------*/
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+/* User includes */
+#include "generate.h"
+
+/*-------------------------------------------------------------------------+
+ | Instances of the benchmark suite: family and size.                      |
+/*-------------------------------------------------------------------------*/
+static const std::vector<std::pair<std::string, int>> suite = {
+  { "ksat", 1000 },      { "ksat", 10000 },      { "ksat", 100000 },
+  { "circuit", 1000 },   { "circuit", 10000 },   { "circuit", 100000 },
+  { "php", 8 },          { "php", 12 },          { "php", 16 },
+  { "redundant", 1000 }, { "redundant", 10000 }, { "redundant", 100000 },
+  { "blocked", 1000 },   { "blocked", 10000 },   { "blocked", 100000 } };
+
+static int usage ( ) {
+
+  std::cerr << "usage: gen_cnf <family> <size> [seed] [key=value ...]\n"
+               "       gen_cnf --suite <dir> [seed]\n"
+               "families: ksat, circuit, php, redundant, blocked" << std::endl;
+  return 1;
+}
+
+int main (int argc, char** argv) {
+
+  if (argc < 3) return usage ( );
+
+/* Write the whole suite to a directory */
+  if (std::string (argv[1]) == "--suite") {
+    const uint64_t seed = argc > 3 ? std::stoull (argv[3]) : 2021;
+    const std::filesystem::path dir = argv[2];
+    std::filesystem::create_directories (dir);
+    for (const auto& instance : suite) {
+      sat::Formula formula;
+      sat::generate (instance.first, instance.second, seed, { }, formula);
+      const std::string name = instance.first + "-" + std::to_string (instance.second) + "-" + std::to_string (seed);
+      std::ofstream out (dir / (name + ".cnf"));
+      sat::write_dimacs (out, formula, name);
+      std::cout << (dir / (name + ".cnf")).string ( ) << " " << formula.vars << " " << formula.clauses ( ) << std::endl;
+    }
+    return 0;
+  }
+
+/* Write a single formula to stdout */
+  const std::string family = argv[1];
+  const int size = atoi (argv[2]);
+  const uint64_t seed = argc > 3 ? std::stoull (argv[3]) : 2021;
+  std::map<std::string, double> params;
+  std::string comment = family + " size " + std::to_string (size) + " seed " + std::to_string (seed);
+  for (int i = 4; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const size_t eq = arg.find ('=');
+    if (eq == std::string::npos) return usage ( );
+    params[arg.substr (0, eq)] = std::stod (arg.substr (eq + 1));
+    comment += " " + arg;
+  }
+  sat::Formula formula;
+  if (size <= 0 || !sat::generate (family, size, seed, params, formula)) return usage ( );
+  sat::write_dimacs (std::cout, formula, comment);
+  return 0;
+}
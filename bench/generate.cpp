@@ -0,0 +1,283 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+
+#include "generate.h"
+
+namespace sat {
+
+/*-------------------------------------------------------------------------+
+ | Number of clauses.                                                      |
+/*-------------------------------------------------------------------------*/
+size_t Formula::clauses ( ) const { return std::count (lits.begin ( ), lits.end ( ), 0); }
+
+/*-------------------------------------------------------------------------+
+ | Append 'clause' and grow 'vars' if needed.                              |
+/*-------------------------------------------------------------------------*/
+void Formula::add (const std::vector<int>& clause) {
+
+  for (const int lit : clause) {
+    lits.push_back (lit);
+    vars = std::max (vars, abs (lit));
+  }
+  lits.push_back (0);
+}
+
+/*-------------------------------------------------------------------------+
+ | Random literal of a variable in [1, vars] and random clauses of 'k'     |
+ | distinct variables.                                                     |
+/*-------------------------------------------------------------------------*/
+static int random_lit (std::mt19937_64& rng, const int vars) {
+
+  const int var = 1 + rng ( ) % vars;
+  return rng ( ) & 1 ? var : -var;
+}
+
+static std::vector<int> random_clause (std::mt19937_64& rng, const int vars, const int k) {
+
+  std::vector<int> clause;
+  while (clause.size ( ) < k) {
+    const int lit = random_lit (rng, vars);
+    bool fresh = true;
+    for (const int other : clause) fresh = fresh && abs (other) != abs (lit);
+    if (fresh) clause.push_back (lit);
+  }
+  return clause;
+}
+
+/*-------------------------------------------------------------------------+
+ | Shuffle with plain modulo (std::shuffle is not portable across          |
+ | standard libraries).                                                    |
+/*-------------------------------------------------------------------------*/
+template <class T> static void shuffle (std::mt19937_64& rng, std::vector<T>& xs) {
+
+  for (size_t i = xs.size ( ); i > 1; --i)
+    std::swap (xs[i - 1], xs[rng ( ) % i]);
+}
+
+/*-------------------------------------------------------------------------+
+ | Uniform random k-SAT with 'ratio' * 'vars' clauses.                     |
+/*-------------------------------------------------------------------------*/
+Formula generate_ksat (const int vars, const int k, const double ratio, const uint64_t seed) {
+
+  std::mt19937_64 rng (seed);
+  Formula formula;
+  const long clauses = ratio * vars;
+  for (long i = 0; i < clauses; ++i)
+    formula.add (random_clause (rng, vars, k));
+  formula.vars = vars;
+  return formula;
+}
+
+/*-------------------------------------------------------------------------+
+ | Tseitin encoding of a random circuit with 'inputs' inputs and 'gates'   |
+ | gates (AND, OR, XOR and ITE over earlier signals with random signs).    |
+ | The output of the last gate is asserted.                                |
+/*-------------------------------------------------------------------------*/
+Formula generate_circuit (const int inputs, const int gates, const uint64_t seed) {
+
+  std::mt19937_64 rng (seed);
+  Formula formula;
+  for (int g = inputs + 1; g <= inputs + gates; ++g) {
+    const int a = random_lit (rng, g - 1);
+    int b = random_lit (rng, g - 1);
+    while (abs (b) == abs (a)) b = random_lit (rng, g - 1);
+    switch (rng ( ) % (g > 3 ? 4 : 3)) {                    // ITE needs three signals
+      case 0:                                               // g = a & b
+        formula.add ({ -g, a }), formula.add ({ -g, b }), formula.add ({ g, -a, -b });
+        break;
+      case 1:                                               // g = a | b
+        formula.add ({ g, -a }), formula.add ({ g, -b }), formula.add ({ -g, a, b });
+        break;
+      case 2:                                               // g = a ^ b
+        formula.add ({ -g, a, b }), formula.add ({ -g, -a, -b });
+        formula.add ({ g, -a, b }), formula.add ({ g, a, -b });
+        break;
+      default: {                                            // g = c ? a : b
+        int c = random_lit (rng, g - 1);
+        while (abs (c) == abs (a) || abs (c) == abs (b)) c = random_lit (rng, g - 1);
+        formula.add ({ -g, -c, a }), formula.add ({ -g, c, b });
+        formula.add ({ g, -c, -a }), formula.add ({ g, c, -b });
+      }
+    }
+  }
+  formula.add ({ inputs + gates });
+  formula.vars = inputs + gates;
+  return formula;
+}
+
+/*-------------------------------------------------------------------------+
+ | Pigeonhole formula: 'holes' + 1 pigeons into 'holes' holes.             |
+/*-------------------------------------------------------------------------*/
+Formula generate_pigeonhole (const int holes) {
+
+  Formula formula;
+  auto var = [holes] (const int pigeon, const int hole) { return pigeon * holes + hole + 1; };
+  for (int p = 0; p <= holes; ++p) {
+    std::vector<int> clause;
+    for (int h = 0; h < holes; ++h) clause.push_back (var (p, h));
+    formula.add (clause);
+  }
+  for (int h = 0; h < holes; ++h)
+    for (int p = 0; p <= holes; ++p)
+      for (int q = p + 1; q <= holes; ++q)
+        formula.add ({ -var (p, h), -var (q, h) });
+  formula.vars = (holes + 1) * holes;
+  return formula;
+}
+
+/*-------------------------------------------------------------------------+
+ | Random 3-5-SAT with 'ratio' * 'vars' base clauses, plus 'duplicates'    |
+ | and 'subsumed' times as many copies (literals shuffled) and supersets   |
+ | (one to three extra literals) of random base clauses, all shuffled.     |
+/*-------------------------------------------------------------------------*/
+Formula generate_redundant (const int vars, const double ratio, const double duplicates, const double subsumed, const uint64_t seed) {
+
+  std::mt19937_64 rng (seed);
+  std::vector<std::vector<int>> clauses;
+  const long base = ratio * vars;
+  for (long i = 0; i < base; ++i)
+    clauses.push_back (random_clause (rng, vars, 3 + rng ( ) % 3));
+  for (long i = 0; i < (long) (duplicates * base); ++i) {
+    std::vector<int> clause = clauses[rng ( ) % base];
+    shuffle (rng, clause);
+    clauses.push_back (clause);
+  }
+  for (long i = 0; i < (long) (subsumed * base); ++i) {
+    std::vector<int> clause = clauses[rng ( ) % base];
+    const size_t size = clause.size ( ) + 1 + rng ( ) % 3;
+    while (clause.size ( ) < size && clause.size ( ) < vars) {
+      const int lit = random_lit (rng, vars);
+      bool fresh = true;
+      for (const int other : clause) fresh = fresh && abs (other) != abs (lit);
+      if (fresh) clause.push_back (lit);
+    }
+    shuffle (rng, clause);
+    clauses.push_back (clause);
+  }
+  shuffle (rng, clauses);
+  Formula formula;
+  for (const std::vector<int>& clause : clauses) formula.add (clause);
+  formula.vars = vars;
+  return formula;
+}
+
+/*-------------------------------------------------------------------------+
+ | Random 3-SAT with 'ratio' * 'vars' clauses followed by 'blocked' times  |
+ | as many planted blocked clauses. A clause planted on 'x' takes the      |
+ | negation of one literal of every clause containing '-x' (so that all    |
+ | resolvents on 'x' are tautologies). Planted clauses never contain the   |
+ | negation of another blocking literal, so each of them stays blocked.    |
+/*-------------------------------------------------------------------------*/
+Formula generate_blocked (const int vars, const double ratio, const double blocked, const uint64_t seed) {
+
+  std::mt19937_64 rng (seed);
+  Formula formula;
+  std::vector<std::vector<int>> clauses;
+  std::vector<std::vector<size_t>> occs (2*vars + 1);        // clauses of literal 'lit + vars'
+  auto add = [&] (const std::vector<int>& clause) {
+    for (const int lit : clause) occs[lit + vars].push_back (clauses.size ( ));
+    clauses.push_back (clause);
+  };
+  const long base = ratio * vars;
+  for (long i = 0; i < base; ++i) add (random_clause (rng, vars, 3));
+
+/* Plant blocked clauses */
+  std::vector<char> blocking (2*vars + 1, 0);               // blocking literals
+  std::vector<char> planted (2*vars + 1, 0);                // literals of planted clauses
+  std::vector<char> marked (2*vars + 1, 0);                 // literals of the current clause
+  const long target = blocked * base;
+  for (long i = 0, tries = 0; i < target && tries < 10*target + 100; ++tries) {
+    const int x = random_lit (rng, vars);
+    if (blocking[x + vars] || blocking[-x + vars] || planted[-x + vars]) continue;
+    std::vector<int> clause = { x };
+    marked[x + vars] = 1;
+    bool ok = true;
+    for (const size_t d : occs[-x + vars]) {
+      bool resolved = false;
+      for (const int lit : clauses[d]) resolved = resolved || (lit != -x && marked[-lit + vars]);
+      if (resolved) continue;
+      std::vector<int> candidates;
+      for (const int lit : clauses[d])
+        if (lit != -x && !marked[lit + vars] && !blocking[lit + vars])
+          candidates.push_back (-lit);
+      if (candidates.empty ( ) || clause.size ( ) >= 8) { ok = false; break; }
+      const int lit = candidates[rng ( ) % candidates.size ( )];
+      clause.push_back (lit);
+      marked[lit + vars] = 1;
+    }
+    for (const int lit : clause) marked[lit + vars] = 0;
+    if (!ok) continue;
+    shuffle (rng, clause);
+    for (const int lit : clause) planted[lit + vars] = 1;
+    blocking[x + vars] = 1;
+    add (clause);
+    ++i;
+  }
+  for (const std::vector<int>& clause : clauses) formula.add (clause);
+  formula.vars = vars;
+  return formula;
+}
+
+/*-------------------------------------------------------------------------+
+ | Generate 'family' (see 'generate.h').                                   |
+/*-------------------------------------------------------------------------*/
+bool generate (const std::string& family, const int size, const uint64_t seed,
+               const std::map<std::string, double>& params, Formula& formula) {
+
+  std::map<std::string, double> p;
+  if      (family == "ksat")      p = { { "k", 3 }, { "ratio", 4.2 } };
+  else if (family == "circuit")   p = { { "inputs", 0.1 } };
+  else if (family == "php")       p = { };
+  else if (family == "redundant") p = { { "ratio", 4 }, { "duplicates", 0.1 }, { "subsumed", 0.2 } };
+  else if (family == "blocked")   p = { { "ratio", 3 }, { "blocked", 0.1 } };
+  else return false;
+  for (const auto& param : params) {
+    if (!p.count (param.first)) return false;
+    p[param.first] = param.second;
+  }
+
+  if (family == "ksat") formula = generate_ksat (size, p["k"], p["ratio"], seed);
+  else if (family == "circuit") {
+    const int inputs = std::max (2, (int) (p["inputs"] * size));
+    formula = generate_circuit (inputs, std::max (1, size - inputs), seed);
+  }
+  else if (family == "php") formula = generate_pigeonhole (size);
+  else if (family == "redundant") formula = generate_redundant (size, p["ratio"], p["duplicates"], p["subsumed"], seed);
+  else formula = generate_blocked (size, p["ratio"], p["blocked"], seed);
+  return true;
+}
+
+/*-------------------------------------------------------------------------+
+ | Write 'formula' in DIMACS with a comment line.                          |
+/*-------------------------------------------------------------------------*/
+void write_dimacs (std::ostream& out, const Formula& formula, const std::string& comment) {
+
+  if (!comment.empty ( )) out << "c " << comment << "\n";
+  out << "p cnf " << formula.vars << " " << formula.clauses ( ) << "\n";
+  for (const int lit : formula.lits)
+    out << lit << (lit ? " " : "\n");
+}
+
+} //End namespace sat
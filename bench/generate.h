@@ -0,0 +1,69 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+
+/*-------- General includes ----------------------------------------*/
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifndef GENERATE_H
+#define GENERATE_H
+
+namespace sat {
+
+/*-------------------------------------------------------------------------+
+ | Deterministic generators of benchmark formulas. The same family, size,  |
+ | seed and parameters always give the same formula on every platform (only|
+ | 'std::mt19937_64' and plain modulo are used). Families: 'ksat' (uniform |
+ | random k-SAT), 'circuit' (Tseitin encoded random circuit of AND, OR, XOR|
+ | and ITE gates), 'php' (pigeonhole), 'redundant' (random 3-5-SAT with a  |
+ | controlled rate of duplicate and subsumed clauses) and 'blocked' (random|
+ | 3-SAT with planted blocked clauses).                                    |
+/*-------------------------------------------------------------------------*/
+struct Formula {
+  int vars = 0;                              // number of variables
+  std::vector<int> lits;                     // 0-terminated clauses (as for 'add_clauses')
+  size_t clauses ( ) const;
+  void add (const std::vector<int>& clause);
+};
+
+Formula generate_ksat (const int vars, const int k, const double ratio, const uint64_t seed);
+Formula generate_circuit (const int inputs, const int gates, const uint64_t seed);
+Formula generate_pigeonhole (const int holes);
+Formula generate_redundant (const int vars, const double ratio, const double duplicates, const double subsumed, const uint64_t seed);
+Formula generate_blocked (const int vars, const double ratio, const double blocked, const uint64_t seed);
+
+/*-------------------------------------------------------------------------+
+ | Generate 'family' with about 'size' variables ('size' holes for 'php'). |
+ | Parameters of the family ('k', 'ratio', 'inputs', 'duplicates',         |
+ | 'subsumed', 'blocked') can be overridden in 'params'. Returns false for |
+ | unknown families or parameters.                                         |
+/*-------------------------------------------------------------------------*/
+bool generate (const std::string& family, const int size, const uint64_t seed,
+               const std::map<std::string, double>& params, Formula& formula);
+void write_dimacs (std::ostream& out, const Formula& formula, const std::string& comment);
+
+} //End namespace sat
+
+#endif
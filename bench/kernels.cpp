@@ -0,0 +1,232 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+
+/*-------------------------------------------------------------------------+
+ | Micro-benchmark of the signature kernels and exact checks on generated  |
+ | occurrence lists. Every list holds clauses of the same size (which sets |
+ | the signature density) containing a common literal and a query clause   |
+ | is checked against all of them as in subsumption, BCE and BVE. Kernels  |
+ | with several instruction set tiers (see 'kernels.h') are timed in every |
+ | tier the CPU supports. Usage: bench_kernels [vars] [repetitions]        |
+/*-------------------------------------------------------------------------*/
+#include <bitset>
+
+/* User includes */
+#include "solver.h"
+
+/*-------------------------------------------------------------------------+
+ | Random clause with 'size' distinct variables which contains 'lit'. With |
+ | 'from' the other literals are taken from 'from' (one of them negated    |
+ | with probability 1/2), otherwise from all variables.                    |
+/*-------------------------------------------------------------------------*/
+static std::vector<int> random_clause (std::mt19937_64& rng, const int vars, const int size, const int lit,
+                                       const std::vector<int>* from = 0) {
+
+  std::vector<int> lits = { lit };
+  const bool negate = from && rng ( ) % 2;
+  while (lits.size ( ) < size) {
+    int other;
+    if (from) other = (*from)[rng ( ) % from->size ( )];
+    else other = (rng ( ) & 1 ? 1 : -1) * (1 + rng ( ) % vars);
+    bool fresh = true;
+    for (const int l : lits) fresh = fresh && abs (l) != abs (other);
+    if (fresh) lits.push_back (other);
+  }
+  if (negate) lits.back ( ) = -lits.back ( );
+  return lits;
+}
+
+/*-------------------------------------------------------------------------+
+ | Occurrence list of 'length' clauses of 'size' literals with the literal |
+ | 'lit' and a query clause of 'query' literals with 'qlit'. A fraction of |
+ | 'hits' of the list is drawn from the query (subsumption candidates).    |
+/*-------------------------------------------------------------------------*/
+struct Workload {
+  Clause* query = 0;
+  std::vector<Clause*> clauses;
+  std::vector<sat::OccrsHash> occs;
+  ~Workload ( );                 // out of line, it is not worth inlining
+};
+
+Workload::~Workload ( ) { }
+
+static Workload workload (sat::CDCL& cdcl, std::mt19937_64& rng, const int vars, const int length,
+                          const int size, const int lit, const int qlit, const int query, const double hits) {
+
+  Workload w;
+  std::vector<int> qlits = random_clause (rng, vars, query, qlit);
+  w.query = cdcl.new_clause (qlits);
+  for (int i = 0; i < length; ++i) {
+    const bool hit = (rng ( ) % 1000) < 1000 * hits && size <= query;
+    Clause* c = cdcl.new_clause (random_clause (rng, vars, size, lit, hit ? &qlits : 0));
+    w.clauses.push_back (c);
+    w.occs.push_back (sat::OccrsHash (c, c->hash, c->unique));
+  }
+  return w;
+}
+
+static void release (sat::CDCL& cdcl, Workload& w) {
+
+  for (Clause* c : w.clauses) cdcl.delete_clause (c);
+  cdcl.delete_clause (w.query);
+}
+
+/*-------------------------------------------------------------------------+
+ | Run 'kernel' (which returns its number of survivors) on a list of       |
+ | 'length' entries, repeated for about 2^20 entries per sample. Returns   |
+ | the best time per entry in nanoseconds and sets 'survivors' per entry.  |
+/*-------------------------------------------------------------------------*/
+template <class F>
+static double time_per_entry (const int length, const int repetitions, double& survivors, F kernel) {
+
+  const long rounds = std::max (1, (1 << 20) / length);
+  double best = 1e100;
+  long total = 0;
+  for (int r = 0; r < repetitions; ++r) {
+    total = 0;
+    auto start = std::chrono::high_resolution_clock::now ( );
+    for (long i = 0; i < rounds; ++i) total += kernel ( );
+    auto end = std::chrono::high_resolution_clock::now ( );
+    best = std::min (best, std::chrono::duration<double>(end - start).count ( ));
+  }
+  survivors = (double) total / (rounds * length);
+  return 1e9 * best / (rounds * length);
+}
+
+int main (int argc, char** argv) {
+
+  const int vars = argc > 1 ? atoi (argv[1]) : 1000;
+  const int repetitions = argc > 2 ? atoi (argv[2]) : 5;
+  const int lengths[] = { 16, 256, 4096 };
+  const int sizes[] = { 3, 8, 24 };
+  const int lit = 1;
+  const int query = 32;
+
+  sat::CDCL cdcl;
+  cdcl.enlarge (vars);
+  std::mt19937_64 rng (2021);
+
+  std::cout << "[kernel, clause size, list length, density, ns/entry, survivors/entry]" << std::endl;
+  for (const int size : sizes) {
+    for (const int length : lengths) {
+      double survivors, ns, density = 0;
+      auto print = [&] (const std::string& kernel) {
+        std::cout << "['" << kernel << "', " << size << ", " << length << ", " << density << ", "
+                  << ns << ", " << survivors << "]," << std::endl;
+      };
+
+    /* Subsumption: list of 'lit', query containing 'lit' */
+      Workload w = workload (cdcl, rng, vars, length, size, lit, lit, query, 0.1);
+      for (const sat::OccrsHash& o : w.occs) density += std::bitset<64> (o.hash).count ( ) / 64.0;
+      density /= length;
+
+      ns = time_per_entry (length, repetitions, survivors, [&] ( ) {
+        long n = 0;
+        const uint64_t nhash = ~w.query->hash, nunique = ~w.query->unique;
+        for (const sat::OccrsHash& o : w.occs) n += sat::subsume_candidate (o, nhash, nunique);
+        return n;
+      });
+      print ("subsume filter");
+
+      for (const std::string& tier : sat::available_kernels ( )) {
+        sat::select_kernels (tier);
+        ns = time_per_entry (length, repetitions, survivors, [&] ( ) {
+          long n = 0;
+          for (Clause* c : w.clauses) { cdcl.compute_hash (c); n += c->unique != 0; }
+          return n;
+        });
+        print ("compute_hash (unique)/" + tier);
+
+        ns = time_per_entry (length, repetitions, survivors, [&] ( ) {
+          long n = 0;
+          const uint64_t nhash = ~w.query->hash, nunique = ~w.query->unique;
+          for (size_t i = 0; i < w.occs.size ( ); i += 64)
+            n += std::bitset<64> (sat::kernels ( ).signature_mask (w.occs.data ( ) + i, std::min<size_t> (64, w.occs.size ( ) - i),
+                                                                   nhash, nunique)).count ( );
+          return n;
+        });
+        print ("signature_mask/" + tier);
+
+        cdcl.mark_sign (w.query);
+        ns = time_per_entry (length, repetitions, survivors, [&] ( ) {
+          long n = 0;
+          for (Clause* c : w.clauses) n += cdcl.subsumed (c) != 0;
+          return n;
+        });
+        cdcl.unmark (w.query);
+        print ("subsumed/" + tier);
+      }
+
+      ns = time_per_entry (length, repetitions, survivors, [&] ( ) {
+        long n = 0;
+        for (Clause* c : w.clauses) n += cdcl.subsumed_merge (w.query, c) != 0;
+        return n;
+      });
+      print ("subsumed_merge");
+
+      ns = time_per_entry (length, repetitions, survivors, [&] ( ) {
+        for (Clause* c : w.clauses) { cdcl.mark_sign (c); cdcl.unmark (c); }
+        return 0L;
+      });
+      survivors = -1;
+      print ("mark_sign/unmark");
+      release (cdcl, w);
+
+    /* BCE/BVE: list of '-lit', query containing 'lit' */
+      w = workload (cdcl, rng, vars, length, size, -lit, lit, size, 0);
+      const uint64_t idx = 1ULL << (lit % 64);
+      ns = time_per_entry (length, repetitions, survivors, [&] ( ) {
+        long n = 0;
+        const uint64_t hci = w.query->hash & ~idx, uci = w.query->unique & idx;
+        for (const sat::OccrsHash& o : w.occs) n += !sat::resolvent_disjoint (hci, uci, o);
+        return n;
+      });
+      print ("resolvent filter");
+
+      cdcl.mark_sign (w.query);
+      ns = time_per_entry (length, repetitions, survivors, [&] ( ) {
+        long n = 0;
+        for (Clause* d : w.clauses) n += cdcl.elim_check_resolvent (w.query, d, lit);
+        return n;
+      });
+      cdcl.unmark (w.query);
+      print ("elim_check_resolvent");
+      release (cdcl, w);
+    }
+  }
+
+/* DIMACS tokenizer: entries are bytes, survivors are numbers */
+  std::string text = "p cnf 0 0\n";
+  for (int i = 0; i < 1 << 18; ++i)
+    text += std::to_string ((rng ( ) & 1 ? 1 : -1) * (1 + (long) (rng ( ) % vars))) + (i % 4 == 3 ? " 0\n" : " ");
+  std::vector<int> numbers;
+  for (const std::string& tier : sat::available_kernels ( )) {
+    sat::select_kernels (tier);
+    double survivors;
+    const double ns = time_per_entry (text.size ( ), repetitions, survivors, [&] ( ) {
+      sat::CDCL::tokenize (text.data ( ) + 9, text.data ( ) + text.size ( ), numbers);
+      return (long) numbers.size ( );
+    });
+    std::cout << "['tokenize/" << tier << "', 0, " << text.size ( ) << ", 0, " << ns << ", " << survivors << "]," << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,42 @@
+#!/bin/sh
+# Two-stage profile-guided build of 'sat' (target 'pgo' in CMakeLists.txt).
+# Stage 1 builds an instrumented 'sat' and 'sat_regress' and trains them on
+# a generated suite (parsing and subsumption through 'sat', all techniques
+# with and without signatures through 'sat_regress'). Stage 2 rebuilds 'sat'
+# in the same directory with the profile. The speedup is measured on a suite
+# of another seed against the reference 'sat'.
+# Usage: pgo.sh <source dir> <build dir> <reference sat> [cmake]
+set -e
+src=$1
+dir=$2
+reference=$3
+cmake=${4:-cmake}
+profile=$dir/profile
+
+# Stage 1: instrumented build and training
+mkdir -p "$dir"
+rm -rf "$profile"
+cd "$dir"
+"$cmake" "$src" -DCMAKE_BUILD_TYPE=Release -DSAT_PGO=generate -DSAT_PGO_DIR="$profile" > /dev/null
+"$cmake" --build . --target sat gen_cnf sat_regress
+rm -rf train measure
+./gen_cnf --suite train 1 > /dev/null
+./gen_cnf --suite measure 2 > /dev/null
+echo "[pgo] training"
+./sat --report train.json train/*.cnf > /dev/null
+SAT_REGRESS_RUNS=1 ./sat_regress train.baseline --update > /dev/null
+
+# Stage 2: optimized build
+"$cmake" "$src" -DSAT_PGO=use > /dev/null
+"$cmake" --build . --target sat
+
+# Best total preprocessing time (see '--report') of three runs of '$1'
+best ( ) {
+  for run in 1 2 3; do
+    "$1" --report time.json measure/*.cnf > /dev/null
+    grep -o '"total":[0-9.e+-]*' time.json | cut -d: -f2 | awk '{ s += $1 } END { print s }'
+  done | sort -g | head -1
+}
+before=$(best "$reference")
+after=$(best ./sat)
+echo "[pgo] $dir/sat: $after s (reference $before s), speedup $(awk "BEGIN { print $before / $after }")"
@@ -0,0 +1,145 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+
+/*-------------------------------------------------------------------------+
+ | Benchmark of the per-instance overhead of fresh vs. reused solvers on   |
+ | many small instances. Usage: bench_reuse [instances] [repetitions]      |
+/*-------------------------------------------------------------------------*/
+#include <filesystem>
+#include <fstream>
+
+/* User includes */
+#include "solver.h"
+
+/*-------------------------------------------------------------------------+
+ | Random 3-SAT instance with 'vars' variables (seeded, so reproducible).  |
+/*-------------------------------------------------------------------------*/
+static std::vector<int> random_3sat (std::mt19937_64& rng, const int vars) {
+
+  std::vector<int> lits;
+  const int clauses = 4.2 * vars;
+  for (int i = 0; i < clauses; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      const int var = 1 + rng ( ) % vars;
+      lits.push_back (rng ( ) & 1 ? var : -var);
+    }
+    lits.push_back (0);
+  }
+  return lits;
+}
+
+/*-------------------------------------------------------------------------+
+ | Write 'lits' (0-terminated clauses) as DIMACS file.                     |
+/*-------------------------------------------------------------------------*/
+static void write_dimacs (const std::string& file_name, const int vars, const std::vector<int>& lits) {
+
+  std::ofstream out (file_name);
+  out << "p cnf " << vars << " " << std::count (lits.begin ( ), lits.end ( ), 0) << "\n";
+  for (const int lit : lits)
+    out << lit << (lit ? " " : "\n");
+}
+
+/*-------------------------------------------------------------------------+
+ | Run all instances 'repetitions' times and return the best time per      |
+ | instance in microseconds.                                               |
+/*-------------------------------------------------------------------------*/
+template <class F>
+static double time_per_instance (const int instances, const int repetitions, F run) {
+
+  double best = 1e100;
+  for (int r = 0; r < repetitions; ++r) {
+    auto start = std::chrono::high_resolution_clock::now ( );
+    run ( );
+    auto end = std::chrono::high_resolution_clock::now ( );
+    best = std::min (best, std::chrono::duration<double>(end - start).count ( ));
+  }
+  return 1e6 * best / instances;
+}
+
+int main (int argc, char** argv) {
+
+  const int instances = argc > 1 ? atoi (argv[1]) : 1000;
+  const int repetitions = argc > 2 ? atoi (argv[2]) : 5;
+
+/* Generate small instances of 20 to 400 variables */
+  std::mt19937_64 rng (2021);
+  std::vector<int> vars;
+  std::vector<std::vector<int>> formulas;
+  std::vector<std::string> files;
+  const std::filesystem::path dir = std::filesystem::temp_directory_path ( ) / "sat_bench_reuse";
+  std::filesystem::create_directories (dir);
+  for (int i = 0; i < instances; ++i) {
+    vars.push_back (20 + rng ( ) % 381);
+    formulas.push_back (random_3sat (rng, vars.back ( )));
+    files.push_back ((dir / ("r" + std::to_string (i) + ".cnf")).string ( ));
+    write_dimacs (files.back ( ), vars.back ( ), formulas.back ( ));
+  }
+
+  std::cout << "[mode, input, fresh (us/instance), reused (us/instance), speedup]" << std::endl;
+  const char* names[] = { "subsume", "block", "elim" };
+  for (int mode = 0; mode < 3; ++mode) {
+    Modes modes;
+    modes.subsume = mode == 0;
+    modes.block   = mode == 1;
+    modes.elim    = mode == 2;
+    modes.hash    = true;
+
+  /* DIMACS files through 'solve' */
+    const double fresh_file = time_per_instance (instances, repetitions, [&] ( ) {
+      for (const std::string& file : files) {
+        sat::CDCL cdcl;
+        cdcl.modes = modes;
+        cdcl.solve (file, { });
+      }
+    });
+    const double reused_file = time_per_instance (instances, repetitions, [&] ( ) {
+      sat::CDCL cdcl;
+      for (const std::string& file : files) {
+        cdcl.reset ( );
+        cdcl.modes = modes;
+        cdcl.solve (file, { });
+      }
+    });
+
+  /* In-memory formulas through 'simplify' */
+    const double fresh_mem = time_per_instance (instances, repetitions, [&] ( ) {
+      for (const std::vector<int>& lits : formulas) {
+        sat::CDCL cdcl;
+        cdcl.add_clauses (lits.data ( ), lits.size ( ));
+        cdcl.simplify (modes);
+      }
+    });
+    const double reused_mem = time_per_instance (instances, repetitions, [&] ( ) {
+      sat::CDCL cdcl;
+      for (const std::vector<int>& lits : formulas) {
+        cdcl.reset ( );
+        cdcl.add_clauses (lits.data ( ), lits.size ( ));
+        cdcl.simplify (modes);
+      }
+    });
+
+    std::cout << "['" << names[mode] << "', 'file', " << fresh_file << ", " << reused_file << ", " << fresh_file / reused_file << "]," << std::endl;
+    std::cout << "['" << names[mode] << "', 'memory', " << fresh_mem << ", " << reused_mem << ", " << fresh_mem / reused_mem << "]," << std::endl;
+  }
+  std::filesystem::remove_all (dir);
+  return 0;
+}
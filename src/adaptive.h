@@ -0,0 +1,80 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+/*-------- General includes ----------------------------------------*/
+#include <cstddef>
+
+#ifndef ADAPTIVE_H
+#define ADAPTIVE_H
+
+namespace sat {
+
+/*-------------------------------------------------------------------------+
+ | Runtime choice between the signature filter and plain marking for the   |
+ | occurrence lists of one technique (see 'modes.adaptive'). Lists are     |
+ | grouped into classes by the logarithm of their length. One in 'period'  |
+ | lists of a class is a sample, which always uses the filter and records  |
+ | with 'record' how many of its trials the filter decided (candidates     |
+ | rejected in subsumption, certificates found in BCE). After 'trials'     |
+ | sampled trials the class uses the filter only if at least one in        |
+ | 'ratio' trials was decided, and the counts are halved, so that the rate |
+ | follows the formula. Both paths give the same results.                  |
+/*-------------------------------------------------------------------------*/
+struct Adaptive {
+
+  static const int classes = 32;
+  static const long trials = 1 << 10;            // sampled trials per decision
+  static const long ratio = 8;                   // decided trials needed (one in 'ratio')
+  static const unsigned period = 16;             // lists per sample
+
+  enum Choice { plain, filter, sample };
+
+  struct Class {
+    long trials = 0;                             // sampled trials
+    long decided = 0;                            // trials decided by the filter
+    unsigned visits = 0;                         // lists visited
+    bool filter = true;                          // use the signature filter
+  };
+  Class table[classes];
+
+  static int length_class (const size_t n) { return 63 - __builtin_clzll (n | 1); }
+
+/* Path for a list of length 'n' */
+  Choice choose (const size_t n) {
+    Class& c = table[length_class (n)];
+    if (++c.visits % period == 0) return sample;
+    return c.filter ? filter : plain;
+  }
+
+/* Record 'n' trials of a sample on a list of length 'length', of which
+   the filter decided 'decided' */
+  void record (const size_t length, const long n, const long decided) {
+    Class& c = table[length_class (length)];
+    c.trials += n, c.decided += decided;
+    if (c.trials < trials) return;
+    c.filter = ratio * c.decided >= c.trials;
+    c.trials /= 2, c.decided /= 2;
+  }
+};
+
+} //End namespace sat
+
+#endif
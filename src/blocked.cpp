@@ -31,16 +31,31 @@ namespace sat {
 /*-------------------------------------------------------------------------*/
 void CDCL::block_call ( ) {
 
+  TraceScope trace ("block_call");
+
 /* Start counter(s) */
   stats.preprocess_start = std::chrono::high_resolution_clock::now ( );
 
 /* Construct occurence lists and occurrences counters */
-  block_init_occrs ( );
+  { Timer timer = phase (Stats::occurrences); block_init_occrs ( ); }
+  Timer timer = phase (Stats::block);
 
-/* Loop over literals */
-  for (int lit = -param.vars; lit <= param.vars; ++lit)
+/* Loop over literals (within the budget) */
+  budget_start (Stats::block);
+  for (int lit = -param.vars; lit <= param.vars && !budget.exhausted ( ); ++lit)
     if (lit && block[abs (lit)])
       block_literal (lit);
+
+/* Covered clauses among the clauses left (within the same budget).
+   The lists are flushed first, as clauses removed by BCE would make
+   the check of covered literals more conservative. */
+  if (modes.cover) {
+    if (modes.apply) flush_occrs ( );
+    for (size_t i = 0; i < original.size ( ) && !budget.exhausted ( ); ++i)
+      if (!original[i]->garbage)
+        block_cover (original[i]);
+  }
+  budget_stop (Stats::block);
 }
 
 /*-------------------------------------------------------------------------+
@@ -49,11 +64,16 @@ void CDCL::block_call ( ) {
 /*-------------------------------------------------------------------------*/
 void CDCL::block_init_occrs ( ) {
 
+  TraceScope trace ("block_init_occrs");
+
 /* Use variable markers to select candidate variables
    If a some literal occurs in a clause that is too large
    we mark it as a non-candidate. */
-  block = new signed char[param.vars + 1] ( );
   memset (block, 1, (param.vars + 1) * sizeof (signed char));
+  for (const int lit : unit_clauses)
+    block[abs (lit)] = 0;
+  for (int var = 1; var <= param.vars; ++var)
+    if (frozen (var)) block[var] = 0;
 
 /* Initialize model for tautology spotting */
   if (modes.hash) {
@@ -92,24 +112,38 @@ void CDCL::block_literal (const int bvar) {
 
 /* Enable hash-based check */
   int blocked = 0;
+  Count checks;
+  Count matches;
   if (modes.hash) {
     const uint64_t idx = 1ULL << (abs (bvar) % 64);
     if (occhash (-bvar).size ( ) > lims.block_max_noccs) return;
     if (!occhash (bvar).size ( )) return;         // pure literal
-    for (const OccrsHash& chu : occhash (bvar))
-      if (block_check_hash (chu, bvar, idx))
+    for (const OccrsHash& chu : occhash (bvar)) {
+      if (budget.exhausted ( )) break;
+      if (modes.apply && chu.c->garbage) continue;
+      if (block_check_hash (chu, bvar, idx, matches)) {
         ++blocked;
-    //stats.block_checks += occhash (bvar).size ( );
+        if (modes.apply) block_remove (chu.c, bvar);
+      }
+    }
+    checks += occhash (bvar).size ( );
 
 /* Regular check */
   } else {
     if (occurs (-bvar).size ( ) > lims.block_max_noccs) return;
     if (!occurs (bvar).size ( )) return;          // pure literal
-    for (const Clause* c : occurs (bvar))
-      if (block_check (c, bvar))
+    for (Clause* c : occurs (bvar)) {
+      if (budget.exhausted ( )) break;
+      if (modes.apply && c->garbage) continue;
+      if (block_check (c, bvar)) {
         ++blocked;
+        if (modes.apply) block_remove (c, bvar);
+      }
+    }
   }
   stats.block_clauses += blocked;
+  checks.flush (stats.block_checks);
+  matches.flush (stats.block_hash_match);
 }
 
 /*-------------------------------------------------------------------------+
@@ -123,9 +157,11 @@ bool CDCL::block_check (const Clause* c, const int bvar) {
    by marking literals 'lit' in 'c' and checking the negative occurrences
    of 'bvar for a clause with no negation of 'lit' in 'c' marked. */
   bool blocked = true;
+  long ticks = c->size ( );
   mark_sign (c);
 
   for (const Clause* d : occurs (-bvar)) {
+    ticks += 1 + d->size ( );
     //assert (d->size ( ) <= lims.block_max_cls_size);
     //if (d->size ( ) > lims.block_max_cls_size) { blocked = false; break; }
     for (const int& lit : *d) {
@@ -137,6 +173,7 @@ bool CDCL::block_check (const Clause* c, const int bvar) {
     next:;
   }
   unmark (c);                                     // unmark literals!
+  budget.tick (ticks);
   return blocked;
 }
 
@@ -145,7 +182,7 @@ bool CDCL::block_check (const Clause* c, const int bvar) {
  | eral marks against clauses in the negative occurrence list of 'bvar'.   |
  | We also include a signature-based preheck.                              |
 /*-------------------------------------------------------------------------*/
-bool CDCL::block_check_hash (const OccrsHash& chu, const int bvar, const uint64_t idx) {
+bool CDCL::block_check_hash (const OccrsHash& chu, const int bvar, const uint64_t idx, Count& matches) {
 
 /* Mark literals in 'c' */
   Clause* c = chu.c;
@@ -154,23 +191,31 @@ bool CDCL::block_check_hash (const OccrsHash& chu, const int bvar, const uint64_
 
 /* Eager check hashes (abs (lit) mod 64) of clauses in the negative
    occurrenceces of 'bvar'. Such a clause cerifies that 'c' cannot
-   be a blocked clause and we may skip a more expensive literal check. */
-  if (modes.hash) {
-    for (const OccrsHash& dhu : occhash (-bvar)) {
-      if ((hci & dhu.hash) != 0ULL) continue;
-      if ((uci & dhu.unique) != 0ULL) continue;
-      //++stats.block_hash_match;                   // statistics
+   be a blocked clause and we may skip a more expensive literal check.
+   Lists on which this rarely succeeds skip it (see 'Adaptive'). */
+  const std::vector<OccrsHash>& occs = occhash (-bvar);
+  const Adaptive::Choice choice = modes.adaptive ? adapt_block.choose (occs.size ( )) : Adaptive::filter;
+  if (choice != Adaptive::plain) {
+    for (size_t i = 0; i < occs.size ( ); i += 64) {
+      budget.tick (std::min<size_t> (64, occs.size ( ) - i));
+      if (!kernels ( ).signature_mask (occs.data ( ) + i, std::min<size_t> (64, occs.size ( ) - i), hci, uci)) continue;
+      ++matches;                                  // statistics
+      if (choice == Adaptive::sample) adapt_block.record (occs.size ( ), 1, 1);
       return false;                               // not a blocker!
     }
-  }
+    if (choice == Adaptive::sample) adapt_block.record (occs.size ( ), 1, 0);
+  } else ++stats.unfiltered;
 
 /* If clause hashes did not provide a certificate then verify blockedness
    by marking literals 'lit' in 'c' and checking the negative occurrences
    of 'bvar for a clause with no negation of 'lit' in 'c' marked. */
   bool blocked = true;
+  long ticks = c->size ( );
   mark_sign (c);
   for (const OccrsHash& dhu : occhash (-bvar)) {
+    if (occurrence_clash (dhu, bvar)) continue;   // tautology (see 'OccrsHash')
     Clause* d = dhu.c;
+    ticks += 1 + d->size ( );
     for (const int& lit : *d) {
       if (lit == -bvar) continue;                 // skip blocker
       if (sign_marked (lit) < 0) goto next;       // marked
@@ -180,7 +225,182 @@ bool CDCL::block_check_hash (const OccrsHash& chu, const int bvar, const uint64_
     next:;
   }
   unmark (c);                                     // unmark literals!
+  budget.tick (ticks);
   return blocked;
 }
 
+/*-------------------------------------------------------------------------+
+ | Remove the blocked clause 'c' and save it with 'bvar' as witness. The   |
+ | clause stays in the occurrence lists, which only makes later checks     |
+ | more conservative.                                                      |
+/*-------------------------------------------------------------------------*/
+void CDCL::block_remove (Clause* c, const int bvar) {
+
+  mark_garbage (c);
+  push_extension (c, bvar);
+}
+
+/*-------------------------------------------------------------------------+
+ | Try covered clause elimination (see 'block_cover') on the clauses with  |
+ | 'lit' (used for the scheduled variables in incremental mode).           |
+/*-------------------------------------------------------------------------*/
+void CDCL::block_cover_clauses (const int lit) {
+
+  const size_t size = modes.hash ? occhash (lit).size ( ) : occurs (lit).size ( );
+  for (size_t i = 0; i < size && !budget.exhausted ( ); ++i) {
+    Clause* c = modes.hash ? occhash (lit)[i].c : occurs (lit)[i];
+    if (!c->garbage) block_cover (c);
+  }
+}
+
+/*-------------------------------------------------------------------------+
+ | Covered and asymmetric blocked clause elimination (CCE/ABCE) as in "Co- |
+ | vered Clause Elimination, 2010". The clause 'c' is extended in 'cover-  |
+ | ed' by two kinds of literals until it is blocked or a tautology:        |
+ |                                                                         |
+ |   asymmetric: '-other' for each binary clause 'lit' 'other' with 'lit'  |
+ |               in the extended clause (equivalent under that clause),    |
+ |   covered:    the literals which all non-tautological resolvents on a   |
+ |               literal 'lit' of the extended clause have in common (see  |
+ |               'block_cover_common').                                    |
+ |                                                                         |
+ | Adding a covered literal is undone by flipping 'lit' if the clause      |
+ | before the addition is falsified. These steps are saved on the exten-   |
+ | sion stack in the order they were made, followed by the final clause    |
+ | with its blocking literal, so that reconstruction undoes them in re-    |
+ | verse. The extended clause has at most 'lims.block_cover_size_max'      |
+ | literals, and only candidate variables (see 'block_init_occrs') are     |
+ | used as witness.                                                        |
+/*-------------------------------------------------------------------------*/
+bool CDCL::block_cover (Clause* c) {
+
+  if (c->size ( ) > lims.block_max_cls_size) return false;   // not in the lists
+  uint64_t hash = 0, unique = 0;                 // signature of 'covered'
+  auto add = [&] (const int lit) {
+    const uint64_t bit = 1ULL << (abs (lit) & 63);
+    unique |= hash & bit;
+    hash |= bit;
+    mark_sign (lit);
+    covered.push_back (lit);
+  };
+  covered.clear ( );
+  cover_steps.clear ( );
+  for (const int lit : *c)
+    add (lit);
+
+  long ticks = 0;
+  Count matches;
+  int witness = 0;
+  bool tautology = false;
+  for (size_t i = 0; i < covered.size ( ) && !witness && !tautology; ++i) {
+    const int lit = covered[i];
+
+  /* Asymmetric literals. A binary clause with both literals in the
+     extended clause makes it a tautology. */
+    const size_t size = modes.hash ? occhash (lit).size ( ) : occurs (lit).size ( );
+    ticks += size;
+    for (size_t j = 0; j < size; ++j) {
+      const Clause* d = modes.hash ? occhash (lit)[j].c : occurs (lit)[j];
+      if (d->size ( ) != 2 || d == c || (modes.apply && d->garbage)) continue;
+      const int other = d->lits[d->lits[0] == lit];
+      const int sign = sign_marked (other);
+      if (sign > 0) { tautology = true; break; }
+      if (!sign && covered.size ( ) < lims.block_cover_size_max) add (-other);
+    }
+    if (tautology || !block[abs (lit)] || frozen (lit)) continue;
+
+  /* Covered literals (none if the clause is blocked on 'lit') */
+    if (!block_cover_common (lit, hash, unique, ticks, matches)) continue;
+    if (cover_common.empty ( )) { witness = lit; break; }
+    cover_steps.emplace_back (lit, covered.size ( ));
+    for (const int other : cover_common)
+      if (covered.size ( ) < lims.block_cover_size_max) add (other);
+  }
+  unmark (covered);
+  budget.tick (ticks);
+  matches.flush (stats.block_hash_match);
+  if (!witness && !tautology) return false;
+
+/* Remove 'c' and save the steps */
+  ++stats.covered;
+  if (modes.apply) {
+    mark_garbage (c);
+    for (const std::pair<int,size_t>& step : cover_steps)
+      push_extension (covered.data ( ), step.second, step.first);
+    if (witness) push_extension (covered.data ( ), covered.size ( ), witness);
+  }
+  return true;
+}
+
+/*-------------------------------------------------------------------------+
+ | Collect in 'cover_common' the literals not in the extended clause that  |
+ | all non-tautological resolvents on 'lit' have in common. Returns false  |
+ | if there are none (some resolvent adds nothing). If it returns true     |
+ | and 'cover_common' is empty, all resolvents are tautological and the    |
+ | extended clause is blocked on 'lit'. With signatures, a clause sharing  |
+ | no variable with the extended clause (see 'resolvent_disjoint') nor     |
+ | with the literals collected so far ends the check without comparing     |
+ | its literals. 'hash' and 'unique' are the signature of 'covered'. As in |
+ | BCE, removed clauses in the lists only make the check more conservative.|
+/*-------------------------------------------------------------------------*/
+bool CDCL::block_cover_common (const int lit, const uint64_t hash, const uint64_t unique, long& ticks,
+                               Count& matches) {
+
+  const size_t size = modes.hash ? occhash (-lit).size ( ) : occurs (-lit).size ( );
+  if (size > lims.block_max_noccs) return false;
+  cover_common.clear ( );
+  bool first = true;
+  uint64_t common = 0;                            // signature of 'cover_common'
+
+/* With signatures, clauses surely giving non-tautological resolvents
+   (see 'resolvent_disjoint') without a common variable fail the check
+   before any literal is compared. The bit of 'lit' only counts for a
+   clause with another variable on it. */
+  const uint64_t idx = 1ULL << (abs (lit) & 63);
+  const uint64_t hci = hash & ~idx;
+  const uint64_t uci = unique & idx;
+  if (modes.hash) {
+    uint64_t all = ~0ULL;
+    for (const OccrsHash& dhu : occhash (-lit))
+      if (resolvent_disjoint (hci, uci, dhu)) all &= dhu.hash & (~idx | dhu.unique);
+    ticks += size;
+    if (!all) {
+      ++matches;                                  // statistics
+      return false;                               // nothing in common
+    }
+  }
+
+/* Intersect the non-tautological resolvents */
+  for (size_t i = 0; i < size; ++i) {
+    const Clause* d = modes.hash ? occhash (-lit)[i].c : occurs (-lit)[i];
+    ++ticks;
+    if (modes.hash && !first && resolvent_disjoint (hci, uci, occhash (-lit)[i]) && !(common & occhash (-lit)[i].hash)) {
+      ++matches;                                  // statistics
+      return false;                               // nothing in common
+    }
+    ticks += d->size ( );
+    bool taut = false;
+    for (const int other : *d)
+      if (other != -lit && sign_marked (other) < 0) { taut = true; break; }
+    if (taut) continue;                           // tautological resolvent
+
+  /* Intersect */
+    size_t j = 0;
+    common = 0;
+    if (first) {
+      for (const int other : *d)
+        if (other != -lit && !sign_marked (other))
+          cover_common.push_back (other), common |= 1ULL << (abs (other) & 63);
+      first = false;
+    } else {
+      for (const int other : cover_common)
+        if (std::find (d->begin ( ), d->end ( ), other) != d->end ( ))
+          cover_common[j++] = other, common |= 1ULL << (abs (other) & 63);
+      cover_common.resize (j);
+    }
+    if (cover_common.empty ( )) return false;     // nothing to add
+  }
+  return true;
+}
+
 } //End namespace sat
\ No newline at end of file
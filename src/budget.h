@@ -0,0 +1,78 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+#ifndef BUDGET_H
+#define BUDGET_H
+
+/*-------- General includes ----------------------------------------*/
+#include <algorithm>
+#include <chrono>
+#include <climits>
+
+/*-------------------------------------------------------------------------+
+ | Effort budget of the running technique in ticks, i.e. occurrence list   |
+ | entries visited plus literals of the clauses compared with each other.  |
+ | The hot loops add their ticks with 'tick' and the technique loops poll  |
+ | 'exhausted' between two units of work (a candidate clause, literal or   |
+ | variable), so a technique always stops with a consistent formula. The   |
+ | clock is only read every 'interval' ticks. Once exhausted the budget    |
+ | stays so until the next 'start'.                                        |
+/*-------------------------------------------------------------------------*/
+struct Budget {
+
+  typedef std::chrono::steady_clock Clock;
+  static const long interval = 1 << 16;          // ticks between deadline checks
+
+  long ticks                               = 0; // ticks of the running technique
+  long limit                               = LONG_MAX; // tick budget of the running technique
+  long checkpoint                          = 0; // ticks of the next check
+  bool stopped                             = false; // technique has to stop
+  bool timeout                             = false; // stopped by the deadline
+  Clock::time_point deadline               = Clock::time_point::max ( ); // end of the call (see 'modes.timeout')
+
+/* Start a technique with at most 'limit_' ticks. The deadline is checked
+   at the first poll. */
+  void start (const long limit_) {
+    ticks = 0, limit = limit_, checkpoint = 0;
+    stopped = timeout = false;
+  }
+
+/* Set the deadline 'seconds' from now (none if not positive) */
+  void expire (const double seconds) {
+    deadline = Clock::time_point::max ( );
+    if (seconds > 0 && seconds < 1e9)
+      deadline = Clock::now ( ) + std::chrono::duration_cast<Clock::duration> (std::chrono::duration<double> (seconds));
+  }
+
+  void tick (const long n) { ticks += n; }
+  bool exhausted ( ) { return ticks >= checkpoint && check ( ); }
+
+/* Slow path of 'exhausted' */
+  bool check ( ) {
+    if (stopped) return true;
+    if (ticks >= limit) return stopped = true;
+    if (Clock::now ( ) >= deadline) return stopped = timeout = true;
+    checkpoint = std::min (limit, ticks + interval);
+    return false;
+  }
+};
+
+#endif
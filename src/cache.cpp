@@ -0,0 +1,287 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+#include "cache.h"
+
+namespace sat {
+
+static const char cache_magic[8] = { 'S', 'A', 'T', 'C', 'A', 'C', 'H', 'E' };
+static const uint32_t cache_version = 7;
+
+/*-------------------------------------------------------------------------+
+ | Fast 64-bit hash of 'size' bytes at 'p' (eight bytes per step).         |
+/*-------------------------------------------------------------------------*/
+static uint64_t hash_bytes (const char* p, size_t size, uint64_t h) {
+
+  auto step = [&h] (const uint64_t w) {
+    h ^= w * 0x9e3779b97f4a7c15ULL;
+    h = ((h << 31) | (h >> 33)) * 0xc2b2ae3d27d4eb4fULL;
+  };
+  step (size);
+  for (; size >= 8; p += 8, size -= 8) {
+    uint64_t w;
+    memcpy (&w, p, 8);
+    step (w);
+  }
+  uint64_t w = 0;
+  memcpy (&w, p, size);
+  step (w);
+
+/* Final avalanche */
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+template <class T> static void put (std::string& out, const T& x) { out.append ((const char*) &x, sizeof x); }
+
+template <class T> static void put (std::string& out, const std::vector<T>& xs) {
+  put (out, (uint64_t) xs.size ( ));
+  out.append ((const char*) xs.data ( ), xs.size ( ) * sizeof (T));
+}
+
+/*-------------------------------------------------------------------------+
+ | Bounds checked reader of a binary record.                               |
+/*-------------------------------------------------------------------------*/
+struct Record {
+
+  Record (const char* p_, const char* end_) : p {p_}, end {end_} { }
+
+  template <class T> bool get (T& x) {
+    if ((size_t) (end - p) < sizeof x) return false;
+    memcpy (&x, p, sizeof x);
+    p += sizeof x;
+    return true;
+  }
+
+  template <class T> bool get (std::vector<T>& xs) {
+    uint64_t size;
+    if (!get (size) || size > (size_t) (end - p) / sizeof (T)) return false;
+    xs.resize (size);
+    memcpy (xs.data ( ), p, size * sizeof (T));
+    p += size * sizeof (T);
+    return true;
+  }
+
+  const char* p;
+  const char* end;
+};
+
+/*-------------------------------------------------------------------------+
+ | Serialize the statistics and the current (simplified) formula together  |
+ | with 'status' to 'out'. The record holds a header, the counters of      |
+ | 'Stats', the unit clauses, the 0-terminated clauses, the extension      |
+ | stack and a checksum of all preceding bytes.                            |
+/*-------------------------------------------------------------------------*/
+void CDCL::write_binary (std::string& out, const int status) const {
+
+  out.assign (cache_magic, sizeof cache_magic);
+  put (out, cache_version);
+  put (out, (int32_t) status);
+  put (out, (int32_t) param.vars);
+  put (out, (int32_t) param.n_cls_start);
+
+/* Statistics */
+  std::vector<int64_t> counters;
+  Stats::visit (stats, [&counters] (const char*, const long& value) { counters.push_back (value); });
+  put (out, counters);
+
+/* Formula and extension stack */
+  put (out, unit_clauses);
+  std::vector<int> lits;
+  for (const Clause& c : clauses ( )) {
+    lits.insert (lits.end ( ), c.begin ( ), c.end ( ));
+    lits.push_back (0);
+  }
+  put (out, lits);
+  put (out, extension);
+  put (out, hash_bytes (out.data ( ), out.size ( ), cache_version));
+}
+
+/*-------------------------------------------------------------------------+
+ | Load a record written by 'write_binary' into the (reset) solver, as if  |
+ | the formula had been read and simplified. Returns false and leaves the  |
+ | solver untouched if the record is truncated or corrupted.               |
+/*-------------------------------------------------------------------------*/
+bool CDCL::read_binary (const std::string& in, int& status) {
+
+  assert (original.empty ( ));
+  assert (unit_clauses.empty ( ));
+  const size_t size = in.size ( ) - sizeof (uint64_t);
+  uint64_t checksum;
+  if (in.size ( ) < sizeof cache_magic + sizeof checksum) return false;
+  memcpy (&checksum, in.data ( ) + size, sizeof checksum);
+  if (checksum != hash_bytes (in.data ( ), size, cache_version)) return false;
+  if (memcmp (in.data ( ), cache_magic, sizeof cache_magic)) return false;
+
+/* Decode record */
+  Record record (in.data ( ) + sizeof cache_magic, in.data ( ) + size);
+  uint32_t version;
+  int32_t status_, vars, n_cls_start;
+  std::vector<int64_t> counters;
+  std::vector<int> units, lits, ext;
+  if (!record.get (version) || version != cache_version) return false;
+  if (!record.get (status_) || !record.get (vars) || !record.get (n_cls_start)) return false;
+  if (!record.get (counters) || counters.size ( ) != stats.counters ( ).size ( )) return false;
+  if (!record.get (units) || !record.get (lits) || !record.get (ext)) return false;
+  if (record.p != record.end || vars < 0) return false;
+  if (!lits.empty ( ) && lits.back ( )) return false;
+  for (const std::vector<int>* xs : { &units, &lits, &ext })
+    for (const int lit : *xs)
+      if (lit == INT_MIN || abs (lit) > vars) return false;
+
+/* Statistics */
+  size_t i = 0;
+  Stats::visit (stats, [&counters, &i] (const char*, long& value) { value = counters[i++]; });
+
+/* Formula */
+  param.vars = vars;
+  enlarge (param.vars);
+  unit_clauses = units;
+  std::vector<int>& clause = add_lits;
+  clause.clear ( );
+  for (const int lit : lits) {
+    if (lit) { clause.push_back (lit); continue; }
+    if (clause.empty ( )) state.inconsistent = true;
+    else if (clause.size ( ) == 1) unit_clauses.push_back (clause[0]);
+    else original.push_back (new_clause (clause));
+    clause.clear ( );
+  }
+
+/* Extension stack (witness first, clause terminated by 0) */
+  extension = ext;
+  bool witness = true;
+  for (const int lit : extension) {
+    if (witness && lit) witnesses[abs (lit)] = 1;
+    witness = !lit;
+  }
+  param.n_cls_start = n_cls_start;
+  param.original = original.size ( );
+  param.units = unit_clauses.size ( );
+  state.inconsistent = state.inconsistent || status_ == 20;
+  status = status_;
+  return true;
+}
+
+/*-------------------------------------------------------------------------+
+ | Key of the input bytes [begin, end) simplified under 'modes' / 'lims'.  |
+/*-------------------------------------------------------------------------*/
+uint64_t Cache::key (const char* begin, const char* end, const Modes& modes, const Limits& lims) {
+
+  const int64_t settings[] = { modes.subsume, modes.block, modes.elim, modes.hash, modes.incremental, modes.adaptive,
+                               modes.substitute, modes.gates, modes.cover, modes.merge,
+                               lims.block_max_cls_size, lims.block_max_noccs, lims.elim_res_size_max,
+                               lims.elim_occrs_max, lims.subsume_max_cls_size, lims.ticks, lims.subsume_ticks,
+                               lims.block_ticks, lims.elim_ticks, (int64_t) (1e6 * lims.subsume_share),
+                               (int64_t) (1e6 * lims.block_share), (int64_t) (1e6 * lims.elim_share) };
+  const uint64_t h = hash_bytes (begin, end - begin, cache_version);
+  return hash_bytes ((const char*) settings, sizeof settings, h);
+}
+
+/*-------------------------------------------------------------------------+
+ | Path of the entry of 'key'.                                             |
+/*-------------------------------------------------------------------------*/
+std::string Cache::entry (const uint64_t key) const {
+
+  char name[32];
+  snprintf (name, sizeof name, "%016llx.cache", (unsigned long long) key);
+  return dir + "/" + name;
+}
+
+/*-------------------------------------------------------------------------+
+ | Load the entry of 'key' into the reset solver 'cdcl'. Returns false on  |
+ | a miss. Entries which cannot be decoded count as misses.                |
+/*-------------------------------------------------------------------------*/
+bool Cache::load (const uint64_t key, CDCL& cdcl, int& status) const {
+
+  const std::string path = entry (key);
+  std::string record;
+  if (!CDCL::read_file (path, record) || !cdcl.read_binary (record, status)) return false;
+
+/* Mark as recently used */
+  std::error_code error;
+  std::filesystem::last_write_time (path, std::filesystem::file_time_type::clock::now ( ), error);
+  return true;
+}
+
+/*-------------------------------------------------------------------------+
+ | Store the result of simplifying the formula of 'key' held by 'cdcl'.    |
+/*-------------------------------------------------------------------------*/
+bool Cache::store (const uint64_t key, const CDCL& cdcl, const int status) const {
+
+  std::string record;
+  cdcl.write_binary (record, status);
+
+/* Write to a private temporary file and rename it into place */
+  std::error_code error;
+  std::filesystem::create_directories (dir, error);
+  const std::string path = entry (key);
+  const std::string tmp = path + ".tmp." + std::to_string (getpid ( )) + "."
+                        + std::to_string (std::hash<std::thread::id> ( ) (std::this_thread::get_id ( )));
+  std::ofstream file (tmp, std::ios::binary | std::ios::trunc);
+  file.write (record.data ( ), record.size ( ));
+  file.close ( );
+  if (!file || std::rename (tmp.c_str ( ), path.c_str ( ))) {
+    std::remove (tmp.c_str ( ));
+    return false;
+  }
+  if (max_bytes) evict ( );
+  return true;
+}
+
+/*-------------------------------------------------------------------------+
+ | Delete least recently used entries until at most 'max_bytes' bytes are  |
+ | left. Entries deleted concurrently by another run are skipped.          |
+/*-------------------------------------------------------------------------*/
+void Cache::evict ( ) const {
+
+  namespace fs = std::filesystem;
+  std::vector<std::pair<fs::file_time_type, std::pair<fs::path, uint64_t>>> entries;
+  uint64_t bytes = 0;
+  std::error_code error;
+  for (fs::directory_iterator it (dir, error), end; !error && it != end; it.increment (error)) {
+    if (it->path ( ).extension ( ) != ".cache") continue;
+    std::error_code missing;
+    const uint64_t size = fs::file_size (it->path ( ), missing);
+    const fs::file_time_type time = fs::last_write_time (it->path ( ), missing);
+    if (missing) continue;
+    entries.push_back ({ time, { it->path ( ), size } });
+    bytes += size;
+  }
+  if (bytes <= max_bytes) return;
+  std::sort (entries.begin ( ), entries.end ( ));
+  for (const auto& entry : entries) {
+    if (bytes <= max_bytes) break;
+    fs::remove (entry.second.first, error);
+    bytes -= entry.second.second;
+  }
+}
+
+} //End namespace sat
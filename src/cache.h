@@ -0,0 +1,71 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+
+/*-------- General includes ----------------------------------------*/
+#include <cstdint>
+#include <string>
+
+/*-------- Header Includes --------------------------------------*/
+#include "solver.h"
+
+#ifndef CACHE_H
+#define CACHE_H
+
+namespace sat {
+
+/*-------------------------------------------------------------------------+
+ | Content addressed on-disk cache of preprocessing results. A result is   |
+ | keyed by a hash of the DIMACS input bytes together with the 'Modes' and |
+ | 'Limits' of the run and holds the statistics and the simplified formula |
+ | in binary form (see 'CDCL::write_binary'), so that a hit skips parsing  |
+ | and all techniques. Entries are written to a temporary file and renamed |
+ | into place, which makes concurrent runs sharing one directory safe:     |
+ | readers either see a complete entry or none. Hits refresh the           |
+ | modification time of an entry and after each store the least recently   |
+ | used entries are deleted until the directory holds at most 'max_bytes'  |
+ | bytes (0 means no limit).                                               |
+/*-------------------------------------------------------------------------*/
+class Cache {
+
+  public:
+
+    Cache ( ) { }
+    Cache (const std::string& dir_, const uint64_t max_bytes_) : dir {dir_}, max_bytes {max_bytes_} { }
+    ~Cache ( ) { }
+
+    bool enabled ( ) const { return !dir.empty ( ); }
+    static uint64_t key (const char* begin, const char* end, const Modes& modes, const Limits& lims);
+    bool load (const uint64_t key, CDCL& cdcl, int& status) const;
+    bool store (const uint64_t key, const CDCL& cdcl, const int status) const;
+
+  private:
+
+    std::string entry (const uint64_t key) const;
+    void evict ( ) const;
+
+    std::string dir;                         // cache directory (empty if disabled)
+    uint64_t max_bytes = 0;                  // size cap of all entries (0 = unlimited)
+};
+
+} //End namespace sat
+
+#endif
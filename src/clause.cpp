@@ -24,34 +24,77 @@
 namespace sat {
 
 /*-------------------------------------------------------------------------+
- | Return a newly allocated Clause containing literals 'lits'.             |
+ | Return a newly allocated Clause containing literals 'lits' (sorted by   |
+ | variable, see 'sort_lits'). Without 'hash' the signature is left to the |
+ | caller (see 'compute_hash').                                            |
 /*-------------------------------------------------------------------------*/
-Clause* CDCL::new_clause (const std::vector<int>& lits) {
+Clause* CDCL::new_clause (const std::vector<int>& lits, const bool hash) {
 
   const size_t size = lits.size ( );
   const size_t bytes = sizeof (Clause) + (size - 2) * sizeof (int);
   Clause* c = (Clause*) new char[bytes]; // allocate memory
   c->length   = size;                    // set length of clause
+  c->garbage  = false;                   // clause is alive
+  c->gate     = false;                   // not part of a gate definition
   for (int i = 0; i < size; ++i)         // copy literals
     c->lits[i] = lits[i];
-  compute_hash (c);
+  sort_lits (c);
+  if (hash) compute_hash (c);
   return c;
 }
 
 /*-------------------------------------------------------------------------+
- | Compute the hash for variables in 'c' and uniqueness of hash.           |
+ | Sort the literals of 'c' by variable. All clauses are kept sorted, so   |
+ | that long clauses can be compared by merging (see 'subsumed_merge').    |
+ | Removing literals keeps the order.                                      |
+/*-------------------------------------------------------------------------*/
+void CDCL::sort_lits (Clause* c) {
+
+  std::sort (c->begin ( ), c->end ( ), [] (const int a, const int b) { return abs (a) < abs (b); });
+}
+
+/*-------------------------------------------------------------------------+
+ | Compute the hash for variables in 'c' and uniqueness of hash (see       |
+ | 'clause_hash' in 'kernels.cpp').                                        |
 /*-------------------------------------------------------------------------*/
 void CDCL::compute_hash (Clause* c) {
 
-  uint64_t hash = 0ULL;
-  uint64_t unique = 0ULL;
-  for (const int lit : *c) {
-    const uint64_t x = 1ULL << ((abs (lit)) & 63ULL);
-    if (hash & x) unique |= x;            // collision signature - u(C)
-    else hash |= x;                       // clause signature    - h(C)
-  }
-  c->hash = hash;
-  c->unique = unique;
+  kernels ( ).clause_hash (c->begin ( ), c->size ( ), c->hash, c->unique);
+}
+
+/*-------------------------------------------------------------------------+
+ | Mark 'c' as removed. With a persistent occurrence index (incremental    |
+ | mode) the variables of 'c' are scheduled for the next BCE/BVE round.    |
+/*-------------------------------------------------------------------------*/
+void CDCL::mark_garbage (Clause* c) {
+
+  assert (!c->garbage);
+  c->garbage = true;
+  ++param.garbage;
+  if (occurring ( ))
+    for (const int lit : *c)
+      mark_dirty (lit);
+}
+
+/*-------------------------------------------------------------------------+
+ | Save a removed clause 'c' on the extension stack. The witness literal   |
+ | is saved first and the clause is terminated by 0. Going through the     |
+ | stack backwards and flipping the witness of each falsified clause ex-   |
+ | tends a model of the simplified formula to the original formula.        |
+/*-------------------------------------------------------------------------*/
+void CDCL::push_extension (const Clause* c, const int witness) {
+
+  push_extension (c->begin ( ), c->size ( ), witness);
+}
+
+void CDCL::push_extension (const int* lits, const size_t size, const int witness) {
+
+  witnesses[abs (witness)] = 1;
+  extension.push_back (witness);
+  for (size_t i = 0; i < size; ++i)
+    if (lits[i] != witness)
+      extension.push_back (lits[i]);
+  extension.push_back (0);
 }
 
 } // End namespace sat
\ No newline at end of file
@@ -22,6 +22,11 @@
 #ifndef CLAUSE_H
 #define CLAUSE_H
 
+/*-------- General includes ----------------------------------------*/
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
 /*-------------------------------------------------------------------------+
  | Clause container.                                                       |
 /*-------------------------------------------------------------------------*/
@@ -29,6 +34,8 @@ struct Clause {
 
   //int id = -1;             // unique clause id (for debugging)
   unsigned short length = 0; // size of lits
+  bool garbage    =   false; // removed by simplification
+  bool gate       =   false; // defines the eliminated variable (see 'elim_find_gate')
   uint64_t hash     =  0ULL; // absolute value hash (mod 64)
   uint64_t unique   =  0ULL; // unique hash markers
   int lits[2];               // literals container
@@ -41,4 +48,36 @@ struct Clause {
   const int* end ( ) const { return &lits[0] + length; }
 };
 
+/*-------------------------------------------------------------------------+
+ | Read-only view of the clauses in a clause container which skips garbage |
+ | clauses. Iterating the view does not copy any clause.                   |
+/*-------------------------------------------------------------------------*/
+class Clauses {
+  public:
+    class iterator {
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Clause value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Clause* pointer;
+        typedef const Clause& reference;
+        iterator (Clause* const* p_, Clause* const* e_) : p {p_}, e {e_} { skip ( ); }
+        const Clause& operator* ( ) const { return **p; }
+        const Clause* operator-> ( ) const { return *p; }
+        iterator& operator++ ( ) { ++p; skip ( ); return *this; }
+        bool operator== (const iterator& it) const { return p == it.p; }
+        bool operator!= (const iterator& it) const { return p != it.p; }
+      private:
+        void skip ( ) { while (p != e && (*p)->garbage) ++p; }
+        Clause* const* p;
+        Clause* const* e;
+    };
+    Clauses (Clause* const* first_, Clause* const* last_) : first {first_}, last {last_} { }
+    iterator begin ( ) const { return iterator (first, last); }
+    iterator end ( ) const { return iterator (last, last); }
+  private:
+    Clause* const* first;
+    Clause* const* last;
+};
+
 #endif
\ No newline at end of file
@@ -28,17 +28,21 @@ namespace sat {
 /*-------------------------------------------------------------------------*/
 void CDCL::elim_call ( ) {
 
+  TraceScope trace ("elim_call");
+
 /* Start counter(s) */
   stats.preprocess_start = std::chrono::high_resolution_clock::now ( );
 
 /* Initialize occurrences, counters and 'elim_heap' */
-  elim_init_occrs ( );
-
-/* Loop over candidate variables */
-  for (int var = 1; var <= param.vars; ++var)
-    elim_variable (var);
-    //if (block[var])
-    //  elim_variable (var);
+  { Timer timer = phase (Stats::occurrences); elim_init_occrs ( ); }
+  Timer timer = phase (Stats::elim);
+
+/* Loop over candidate variables (within the budget) */
+  budget_start (Stats::elim);
+  for (int var = 1; var <= param.vars && !budget.exhausted ( ); ++var)
+    if (block[var])
+      elim_variable (var);
+  budget_stop (Stats::elim);
 }
 
 /*-------------------------------------------------------------------------+
@@ -46,11 +50,16 @@ void CDCL::elim_call ( ) {
 /*-------------------------------------------------------------------------*/
 void CDCL::elim_init_occrs ( ) {
 
+  TraceScope trace ("elim_init_occrs");
+
 /* Use variable markers to select candidate variables
    If a some literal occurs in a clause that is too large
    we mark it as a non-candidate. */
-  block = new signed char[param.vars + 1] ( );
   memset (block, 1, (param.vars + 1) * sizeof (signed char));
+  for (const int lit : unit_clauses)
+    block[abs (lit)] = 0;
+  for (int var = 1; var <= param.vars; ++var)
+    if (frozen (var)) block[var] = 0;
 
 /* Initialize occurrence list with signatures */
   if (!modes.hash) {
@@ -87,6 +96,9 @@ void CDCL::elim_init_occrs ( ) {
 /*-------------------------------------------------------------------------*/
 void CDCL::elim_variable (int evar) {
 
+/* Skip clauses removed by earlier eliminations */
+  if (modes.apply) { flush_occrs (evar); flush_occrs (-evar); }
+
 /* Pure literal or too many occurrences */
   if (modes.hash) {
     if (!occhash (evar).size ( ) || !occhash (-evar).size ( )) return;
@@ -100,12 +112,97 @@ void CDCL::elim_variable (int evar) {
   }
 
 /* Eliminate if resolvents pos x neg are bounded (i.e., if
-   |pos x neg| < |pos| + |neg| + 'param.elim_bound') */
-  if (modes.hash) {
-    if (elim_resolvents_bounded_signature (evar))
-      ++stats.eliminated;
-  } else if (elim_resolvents_bounded (evar))
+   |pos x neg| < |pos| + |neg| + 'param.elim_bound'). If 'evar' is
+   defined by a gate, only the resolvents of gate clauses with non-gate
+   clauses are needed (see 'elim_find_gate'). */
+  bool bounded;
+  if (modes.gates && elim_find_gate (evar)) bounded = elim_resolvents_bounded_gate (evar);
+  else if (modes.hash) bounded = elim_resolvents_bounded_signature (evar);
+  else bounded = elim_resolvents_bounded (evar);
+  if (bounded) {
     ++stats.eliminated;
+    if (modes.apply) elim_eliminate (evar);
+  }
+  for (Clause* c : gates) c->gate = false;
+  gates.clear ( );
+}
+
+/*-------------------------------------------------------------------------+
+ | Eliminate 'evar' by replacing its occurrences with all non-tautological |
+ | resolvents pos x neg (only those of gate with non-gate clauses if there |
+ | is a gate). The antecedents are saved on the extension stack. With      |
+ | 'modes.subsume' the resolvents also remove the clauses they subsume.    |
+/*-------------------------------------------------------------------------*/
+void CDCL::elim_eliminate (const int evar) {
+
+/* Collect the clauses containing 'evar' and '-evar' */
+  elim_collect (evar);
+  const std::vector<Clause*>& pos = elim_pos;
+  const std::vector<Clause*>& neg = elim_neg;
+  if (modes.hash) occhash (evar).clear ( ), occhash (-evar).clear ( );
+  else            occurs (evar).clear ( ), occurs (-evar).clear ( );
+
+/* Add resolvents. Literals of 'd' marked with the same sign
+   are duplicates and literals marked negatively tautologies. */
+  const size_t resolvents = original.size ( );
+  std::vector<int> lits;
+  for (Clause* c : pos) {
+    mark_sign (c);
+    for (Clause* d : neg) {
+      if (!gates.empty ( ) && c->gate == d->gate) continue;
+      budget.tick (c->size ( ) + d->size ( ));
+      lits.clear ( );
+      for (const int lit : *c)
+        if (lit != evar) lits.push_back (lit);
+      for (const int lit : *d) {
+        if (lit == -evar) continue;
+        const signed char sign = sign_marked (lit);
+        if (sign < 0) goto tautology;
+        if (!sign) lits.push_back (lit);
+      }
+      elim_add_resolvent (lits);
+      tautology:;
+    }
+    unmark (c);
+  }
+
+/* Remove antecedents */
+  for (Clause* c : pos) { mark_garbage (c); push_extension (c, evar); }
+  for (Clause* d : neg) { mark_garbage (d); push_extension (d, -evar); }
+
+/* Remove the clauses subsumed by the resolvents (see 'subsume_backward') */
+  if (modes.subsume)
+    for (size_t i = resolvents; i < original.size ( ) && !budget.exhausted ( ); ++i)
+      if (!original[i]->garbage && original[i]->size ( ) <= lims.subsume_max_cls_size)
+        subsume_backward (original[i]);
+}
+
+/*-------------------------------------------------------------------------+
+ | Collect the clauses containing 'evar' in 'elim_pos' and those contain-  |
+ | ing '-evar' in 'elim_neg'.                                              |
+/*-------------------------------------------------------------------------*/
+void CDCL::elim_collect (const int evar) {
+
+  elim_pos.clear ( ), elim_neg.clear ( );
+  each_clause (evar, [this] (Clause* c, uint64_t) { elim_pos.push_back (c); });
+  each_clause (-evar, [this] (Clause* c, uint64_t) { elim_neg.push_back (c); });
+}
+
+/*-------------------------------------------------------------------------+
+ | Add the resolvent 'lits' to the clauses and occurrence lists. Variables |
+ | of unit resolvents and too large resolvents are no longer eliminated.   |
+/*-------------------------------------------------------------------------*/
+void CDCL::elim_add_resolvent (const std::vector<int>& lits) {
+
+  assert (!lits.empty ( ));
+  if (lits.size ( ) == 1) {
+    unit_clauses.push_back (lits[0]);
+    block[abs (lits[0])] = 0;
+    return;
+  }
+  Clause* c = new_clause (lits);
+  original.push_back (c);
+  add_occrs (c, lims.elim_res_size_max);
 }
 
 /*-------------------------------------------------------------------------+
@@ -120,15 +217,18 @@ bool CDCL::elim_resolvents_bounded (const int evar) {
   std::vector<Clause*>& neg = occurs (-evar);
   const size_t bound = pos.size ( ) + neg.size ( ) + param.elim_bound;
   int count = 0;
+  long ticks = 0;
 
 /* Check if the number of resolvents (pos x neg) is bounded */
   for (Clause* c : pos) {
 
   /* Mark literals in 'c' */
     mark_sign (c);
+    ticks += c->size ( );
 
   /* Check negative occurrence list for tautological resolvents */
     for (Clause* d : neg) {
+      ticks += 1 + d->size ( );
 
     /* Check whether resolvents is tautological in the old fashion way */
       if (elim_check_resolvent (c, d, evar))
@@ -136,6 +236,7 @@ bool CDCL::elim_resolvents_bounded (const int evar) {
 
       if (count > bound) {
         unmark (c);
+        budget.tick (ticks);
         return false;
       }
     }
@@ -143,6 +244,7 @@ bool CDCL::elim_resolvents_bounded (const int evar) {
   /* Unmark literals */
     unmark (c);
   }
+  budget.tick (ticks);
   return true;
 }
 
@@ -158,26 +260,27 @@ bool CDCL::elim_resolvents_bounded_signature (const int evar) {
   std::vector<OccrsHash>& neg = occhash (-evar);
   const size_t bound = pos.size ( ) + neg.size ( ) + param.elim_bound;
   int count = 0;
-  int checks = 0;
-  int hash_matches = 0;
+  Count checks;
+  Count hash_matches;
   const uint64_t idx = 1ULL << (abs (evar) % 64);
 
   for (const OccrsHash& chu : pos) {
     const uint64_t hci = chu.hash & ~idx;
     const uint64_t uci = chu.unique & idx;
-    for (const OccrsHash& dhu : neg) {
-      //++checks;
-      if ((hci & dhu.hash) != 0ULL) continue;
-      if ((uci & dhu.unique) != 0ULL) continue;
-      //++hash_matches;
-      if (++count > bound) {
-        //stats.elim_hash_matches += hash_matches;
-        //stats.elim_checks += checks;
+    for (size_t i = 0; i < neg.size ( ); i += 64) {
+      const size_t n = std::min<size_t> (64, neg.size ( ) - i);
+      const int disjoint = __builtin_popcountll (kernels ( ).signature_mask (neg.data ( ) + i, n, hci, uci));
+      budget.tick (n);
+      checks += n;
+      hash_matches += disjoint;
+      if ((count += disjoint) > bound) {
+        hash_matches.flush (stats.elim_hash_matches);
+        checks.flush (stats.elim_checks);
         return false;
       }
     }
   }
-  //stats.elim_hash_matches += hash_matches;
+  hash_matches.flush (stats.elim_hash_matches);
 
 /* Check if the number of resolvents (pos x neg) is bounded */
   for (const OccrsHash& chu : pos) {
@@ -186,33 +289,241 @@ bool CDCL::elim_resolvents_bounded_signature (const int evar) {
 
   /* Mark literals in 'c' and the negation of the resolution literal */
     bool marked = false;
-    for (const OccrsHash& dhu : neg) {
+    for (size_t i = 0; i < neg.size ( ); i += 64) {
+      const size_t n = std::min<size_t> (64, neg.size ( ) - i);
+      const uint64_t valid = n < 64 ? (1ULL << n) - 1 : ~0ULL;
 
     /* Skip if counted during signature test */
-      if ((hci & dhu.hash) == 0ULL) {
-        if ((uci & dhu.unique) == 0ULL)
-          continue;
-      }
-      //++checks;
-
-    /* Mark literals (if not already marked) */
-      if (!marked) { mark_sign (chu.c); marked = true; }
-
-    /* Check whether resolvents is tautological in the old fashion way */
-      if (elim_check_resolvent (chu.c, dhu.c, evar)) {
-        if (++count > bound) {
-          if (marked) unmark (chu.c);
-          //stats.elim_checks += checks;
-          return false;
+      for (uint64_t m = ~kernels ( ).signature_mask (neg.data ( ) + i, n, hci, uci) & valid; m; m &= m - 1) {
+        const OccrsHash& dhu = neg[i + __builtin_ctzll (m)];
+        ++checks;
+
+      /* Mark literals (if not already marked) */
+        if (!marked) { mark_sign (chu.c); marked = true; }
+        if (occurrence_clash (dhu, evar)) continue; // tautology (see 'OccrsHash')
+        budget.tick (1 + dhu.c->size ( ));
+
+      /* Check whether resolvents is tautological in the old fashion way */
+        if (elim_check_resolvent (chu.c, dhu.c, evar)) {
+          if (++count > bound) {
+            if (marked) unmark (chu.c);
+            checks.flush (stats.elim_checks);
+            return false;
+          }
         }
       }
     }
     if (marked) unmark (chu.c);
   }
-  //stats.elim_checks += checks;
+  checks.flush (stats.elim_checks);
+  return true;
+}
+
+/*-------------------------------------------------------------------------+
+ | Find clauses which define 'evar' as a gate of other variables and flag  |
+ | them as 'gate' (see 'elim_flag_gate'). Resolvents of two gate clauses   |
+ | are tautological and those of two non-gate clauses are implied by the   |
+ | gate ones ("Effective Preprocessing in SAT through Variable and Clause  |
+ | Elimination", 2005), so BVE only needs the resolvents of gate with      |
+ | non-gate clauses. We look for equivalences and AND/OR gates on both     |
+ | literals, if-then-else gates and XOR gates (in this order).             |
+/*-------------------------------------------------------------------------*/
+bool CDCL::elim_find_gate (const int evar) {
+
+  if (elim_find_and (evar) || elim_find_and (-evar)) { ++stats.elim_gates; return true; }
+
+/* The clauses of if-then-else and XOR gates come in pairs with the same
+   variables in both literals, and thus the same signature */
+  gate_hashes.clear ( );
+  each_clause (-evar, [this] (Clause*, const uint64_t hash) {
+    if (__builtin_popcountll (hash) <= lims.elim_xor_size_max) gate_hashes.push_back (hash);
+  });
+  bool paired = false;
+  each_clause (evar, [&] (Clause*, const uint64_t hash) {
+    paired = paired || std::find (gate_hashes.begin ( ), gate_hashes.end ( ), hash) != gate_hashes.end ( );
+  });
+  budget.tick (gate_hashes.size ( ));
+  if (!paired || (!elim_find_ite (evar) && !elim_find_xor (evar))) return false;
+  ++stats.elim_gates;
   return true;
 }
 
+/*-------------------------------------------------------------------------+
+ | Flag 'c' as a gate clause.                                              |
+/*-------------------------------------------------------------------------*/
+void CDCL::elim_flag_gate (Clause* c) {
+
+  c->gate = true;
+  gates.push_back (c);
+}
+
+/*-------------------------------------------------------------------------+
+ | Find an AND gate '-lit = a_1 & ... & a_n', i.e., binary clauses         |
+ | 'lit a_i' and a clause '-lit -a_1 ... -a_n' (an equivalence if n = 1).  |
+ | The literals 'a_i' of the binary clauses are marked and the signature of|
+ | their variables rejects clauses of '-lit' with other variables before   |
+ | their literals are checked.                                             |
+/*-------------------------------------------------------------------------*/
+bool CDCL::elim_find_and (const int lit) {
+
+/* Mark the other literals of the binary clauses of 'lit' */
+  gate_binaries.clear ( );
+  uint64_t others = 0;
+  each_clause (lit, [&] (Clause* c, uint64_t) {
+    if (c->size ( ) != 2) return;
+    const int other = c->lits[c->lits[0] == lit];
+    mark_sign (other);
+    others |= 1ULL << (abs (other) & 63);
+    gate_binaries.push_back (c);
+  });
+  budget.tick (modes.hash ? occhash (lit).size ( ) : occurs (lit).size ( ));
+  if (gate_binaries.empty ( )) return false;
+  const uint64_t idx = 1ULL << (abs (lit) & 63);
+
+/* Find the defining clause among the clauses of '-lit' */
+  Clause* def = 0;
+  each_clause (-lit, [&] (Clause* c, const uint64_t hash) {
+    if (def || (hash & ~idx & ~others)) return;
+    budget.tick (c->size ( ));
+    for (const int other : *c)
+      if (other != -lit && sign_marked (other) >= 0) return;
+    def = c;
+  });
+
+/* Flag it and the binary clauses of its literals */
+  if (def) {
+    elim_flag_gate (def);
+    for (const int other : *def) {
+      if (other == -lit) continue;
+      for (Clause* b : gate_binaries)
+        if (b->lits[b->lits[0] == lit] == -other && !b->gate) { elim_flag_gate (b); break; }
+    }
+  }
+  for (Clause* b : gate_binaries) unmark (b->lits[b->lits[0] == lit]);
+  return def;
+}
+
+/*-------------------------------------------------------------------------+
+ | Find an if-then-else gate 'evar = a ? t : e' given by the four clauses  |
+ | '-evar -a t', 'evar -a -t', '-evar a e' and 'evar a -e'. Clauses of a   |
+ | pair ('-evar -a t', 'evar -a -t') have the same variables and thus the  |
+ | same signature, which is compared before their literals.                |
+/*-------------------------------------------------------------------------*/
+bool CDCL::elim_find_ite (const int evar) {
+
+/* Pairs of ternary clauses 'evar c t' and '-evar c -t' with condition 'c' */
+  struct Pair { Clause* c; Clause* d; int cond; };
+  std::vector<Pair> pairs;
+  each_clause (evar, [&] (Clause* c, const uint64_t hash) {
+    if (__builtin_popcountll (hash) > 3 || c->size ( ) != 3) return;
+    const int* lits = c->begin ( );
+    const int x = lits[0] == evar ? lits[1] : lits[0];
+    const int y = lits[2] == evar ? lits[1] : lits[2];
+    each_clause (-evar, [&] (Clause* d, const uint64_t dhash) {
+      budget.tick (1);
+      if (dhash != hash || d->size ( ) != 3 || d->unique != c->unique) return;
+      int same = 0, flipped = 0;
+      for (const int lit : *d) {
+        if (lit == -evar) continue;
+        if (lit == x || lit == y) same = lit;
+        else if (lit == -x || lit == -y) flipped = lit;
+      }
+      if (same && flipped) pairs.push_back ({ c, d, same });
+    });
+  });
+
+/* Two pairs with complementary conditions give the gate */
+  for (size_t i = 0; i < pairs.size ( ); ++i)
+    for (size_t j = i + 1; j < pairs.size ( ); ++j)
+      if (pairs[i].cond == -pairs[j].cond) {
+        for (const Pair& pair : { pairs[i], pairs[j] })
+          elim_flag_gate (pair.c), elim_flag_gate (pair.d);
+        return true;
+      }
+  return false;
+}
+
+/*-------------------------------------------------------------------------+
+ | Find an XOR gate 'evar = a_1 ^ ... ^ a_n' (with n + 1 at most           |
+ | 'lims.elim_xor_size_max' and 5), i.e., all 2^n clauses over the         |
+ | variables of the gate with the same parity of negative literals. These  |
+ | clauses have the same signature, which is compared before their         |
+ | literals. The clauses found are recorded by the literals they flip with |
+ | respect to 'c'.                                                         |
+/*-------------------------------------------------------------------------*/
+bool CDCL::elim_find_xor (const int evar) {
+
+  bool found = false;
+  each_clause (evar, [&] (Clause* c, const uint64_t hash) {
+    if (found || __builtin_popcountll (hash) > std::min (lims.elim_xor_size_max, 5)) return;
+    const int size = c->size ( );
+    if (size > std::min (lims.elim_xor_size_max, 5)) return;
+    Clause* clauses[1 << 5] = { };                    // by flipped literals
+    uint32_t patterns = 0;
+    auto check = [&] (Clause* d, const uint64_t dhash) {
+      budget.tick (1);
+      if (dhash != hash || d->size ( ) != size || d->unique != c->unique) return;
+      uint32_t flipped = 0;
+      for (const int lit : *d) {
+        int i = 0;
+        while (i < size && abs (c->lits[i]) != abs (lit)) ++i;
+        if (i == size) return;
+        if (lit != c->lits[i]) flipped |= 1u << i;
+      }
+      if (__builtin_popcount (flipped) & 1) return;
+      if (patterns & (1u << flipped)) return;
+      patterns |= 1u << flipped;
+      clauses[flipped] = d;
+    };
+    each_clause (evar, check);
+    each_clause (-evar, check);
+    if (__builtin_popcount (patterns) != 1 << (size - 1)) return;
+    for (Clause* d : clauses)
+      if (d) elim_flag_gate (d);
+    found = true;
+  });
+  return found;
+}
+
+/*-------------------------------------------------------------------------+
+ | Check if the resolvents of the gate clauses with non-gate clauses on    |
+ | 'evar' are bounded (see 'elim_resolvents_bounded'). With signatures the |
+ | pairs without another common variable are counted without checking their|
+ | literals.                                                               |
+/*-------------------------------------------------------------------------*/
+bool CDCL::elim_resolvents_bounded_gate (const int evar) {
+
+  elim_collect (evar);
+  const size_t bound = elim_pos.size ( ) + elim_neg.size ( ) + param.elim_bound;
+  const uint64_t idx = 1ULL << (abs (evar) % 64);
+  size_t count = 0;
+  Count checks;
+  Count hash_matches;
+  for (Clause* c : elim_pos) {
+    const uint64_t hci = c->hash & ~idx;
+    const uint64_t uci = c->unique & idx;
+    bool marked = false;
+    for (Clause* d : elim_neg) {
+      if (c->gate == d->gate) continue;
+      ++checks;
+      if (modes.hash && resolvent_disjoint (hci, uci, OccrsHash (d, d->hash, d->unique))) {
+        budget.tick (1);
+        ++hash_matches;
+      } else {
+        budget.tick (1 + d->size ( ));
+        if (!marked) { mark_sign (c); marked = true; }
+        if (!elim_check_resolvent (c, d, evar)) continue;
+      }
+      if (++count > bound) break;
+    }
+    if (marked) unmark (c);
+    if (count > bound) break;
+  }
+  checks.flush (stats.elim_checks);
+  hash_matches.flush (stats.elim_hash_matches);
+  return count <= bound;
+}
+
 /*-------------------------------------------------------------------------+
  | Check if the resolvent between 'c' and 'd' on 'elit' is valid. Assumes  |
  | 'elit' is in 'c' and '-elit' in 'd'. The function fails for tautological|
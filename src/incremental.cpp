@@ -0,0 +1,222 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+#include "solver.h"
+
+namespace sat {
+
+/*-------------------------------------------------------------------------+
+ | Freeze the variable of 'lit', which excludes it from BCE and BVE until  |
+ | it is melted again. Removed clauses with a witness on the variable are  |
+ | restored, since the variable may occur in clauses added later on.       |
+/*-------------------------------------------------------------------------*/
+void CDCL::freeze (const int lit) {
+
+  const int var = abs (lit);
+  if (var > param.vars) param.vars = var;
+  enlarge (param.vars);
+  if (witnesses[var]) restore_clauses ({ var });
+  ++frozentab[var];
+}
+
+/*-------------------------------------------------------------------------+
+ | Undo one 'freeze' of the variable of 'lit'.                             |
+/*-------------------------------------------------------------------------*/
+void CDCL::melt (const int lit) {
+
+  assert (frozen (lit));
+  --frozentab[abs (lit)];
+}
+
+/*-------------------------------------------------------------------------+
+ | Add the assumption 'lit' for the next call of 'simplify'. The variable  |
+ | of 'lit' is frozen during that call only.                               |
+/*-------------------------------------------------------------------------*/
+void CDCL::assume (const int lit) {
+
+  if (abs (lit) > param.vars) param.vars = abs (lit);
+  assumptions.push_back (lit);
+}
+
+/*-------------------------------------------------------------------------+
+ | Schedule the variable of 'lit' for the next BCE/BVE round.              |
+/*-------------------------------------------------------------------------*/
+void CDCL::mark_dirty (const int lit) {
+
+  const int var = abs (lit);
+  if (dirty[var]) return;
+  dirty[var] = 1;
+  dirty_vars.push_back (var);
+}
+
+/*-------------------------------------------------------------------------+
+ | Incremental simplification. The occurrence index (with signatures if    |
+ | 'modes.hash') is built on the first call and kept alive afterwards.     |
+ | Clauses added since the last call are checked for subsumption against   |
+ | the index and then inserted. BCE and BVE only visit variables whose     |
+ | occurrences changed (see 'mark_dirty'), so the cost of a call scales    |
+ | with the number of added and removed clauses. Frozen variables and      |
+ | assumptions are never blocking literals or eliminated.                  |
+/*-------------------------------------------------------------------------*/
+void CDCL::simplify_incremental ( ) {
+
+/* Build the persistent occurrence index on the first call */
+  if (!occurring ( )) {
+    init_block ( );
+    if (modes.hash) init_occrs_hash ( );
+    else            init_occrs ( );
+    state.hash = modes.hash;
+    state.occurring = true;
+  } else {
+    assert (state.hash == modes.hash);
+    modes.hash = state.hash;
+    if (modes.hash) init_occrs_hash ( );
+    else            init_occrs ( );
+  }
+
+/* Insert new clauses into the index */
+  stats.preprocess_start = std::chrono::high_resolution_clock::now ( );
+  if (modes.subsume) { Timer timer = phase (Stats::subsume);     subsume_incremental ( ); }
+  else               { Timer timer = phase (Stats::occurrences); incremental_index ( ); }
+
+/* Units are excluded from BCE/BVE */
+  for ( ; param.units < unit_clauses.size ( ); ++param.units)
+    block[abs (unit_clauses[param.units])] = 0;
+
+/* Take the current schedule and remove garbage clauses of earlier calls
+   from it. Clauses are garbage only if one of their variables is dirty. */
+  std::vector<int> schedule;
+  schedule.swap (dirty_vars);
+  for (const int var : schedule) {
+    dirty[var] = 0;
+    flush_occrs (var), flush_occrs (-var);
+  }
+
+/* BCE on the scheduled variables (and CCE on their clauses). Variables
+   not (completely) visited within the budget are scheduled again for
+   the next call. */
+  if (modes.block) {
+    Timer timer = phase (Stats::block);
+    budget_start (Stats::block);
+    for (const int var : schedule) {
+      if (block[var] && !frozen (var) && !budget.exhausted ( ))
+        block_literal (var), block_literal (-var);
+      if (budget.stopped) mark_dirty (var);
+    }
+    if (modes.cover) {
+      for (const int var : dirty_vars)            // clauses removed by BCE
+        flush_occrs (var), flush_occrs (-var);
+      for (const int var : schedule) {
+        if (!budget.exhausted ( )) block_cover_clauses (var), block_cover_clauses (-var);
+        if (budget.stopped) mark_dirty (var);
+      }
+    }
+    budget_stop (Stats::block);
+  }
+
+/* BVE on the scheduled variables and those touched by BCE. Variables
+   touched by BVE itself are left for the next call, and so are those
+   not visited within the budget. */
+  if (modes.elim) {
+    Timer timer = phase (Stats::elim);
+    budget_start (Stats::elim);
+    const size_t touched = dirty_vars.size ( );
+    for (const int var : schedule) {
+      if (block[var] && !frozen (var) && !budget.exhausted ( ))
+        elim_variable (var);
+      if (budget.stopped) mark_dirty (var);
+    }
+    for (size_t i = 0; i < touched && !budget.exhausted ( ); ++i)
+      if (block[dirty_vars[i]] && !frozen (dirty_vars[i]))
+        elim_variable (dirty_vars[i]);
+    budget_stop (Stats::elim);
+  }
+}
+
+/*-------------------------------------------------------------------------+
+ | Insert clauses added since the last call into the occurrence index.     |
+/*-------------------------------------------------------------------------*/
+void CDCL::incremental_index ( ) {
+
+  for (size_t i = param.original; i < original.size ( ); ++i)
+    if (!original[i]->garbage)
+      add_occrs (original[i], lims.block_max_cls_size);
+  param.original = original.size ( );
+}
+
+/*-------------------------------------------------------------------------+
+ | Restore removed clauses which are invalidated by the clauses and units  |
+ | added since the last call or by assumptions. A removed clause has to be |
+ | restored if its witness variable occurs in such a clause. Restored      |
+ | clauses may in turn invalidate clauses removed after them, so their     |
+ | variables are tainted as well while going through the stack.            |
+/*-------------------------------------------------------------------------*/
+void CDCL::restore ( ) {
+
+  std::vector<int> seeds;
+  for (size_t i = param.original; i < original.size ( ); ++i)
+    for (const int lit : *original[i])
+      if (witnesses[abs (lit)]) seeds.push_back (abs (lit));
+  for (size_t i = param.units; i < unit_clauses.size ( ); ++i)
+    if (witnesses[abs (unit_clauses[i])]) seeds.push_back (abs (unit_clauses[i]));
+  for (const int lit : assumptions)
+    if (witnesses[abs (lit)]) seeds.push_back (abs (lit));
+  if (!seeds.empty ( )) restore_clauses (seeds);
+}
+
+/*-------------------------------------------------------------------------+
+ | Restore the clauses on the extension stack whose witness variable is    |
+ | tainted, starting from the variables 'seeds'. The restored clauses are  |
+ | added as new clauses.                                                   |
+/*-------------------------------------------------------------------------*/
+void CDCL::restore_clauses (const std::vector<int>& seeds) {
+
+  std::vector<signed char> taint (param.vars + 1, 0);
+  for (const int var : seeds) taint[var] = 1;
+
+/* Go through the stack in the order of removal */
+  std::vector<int> lits;
+  size_t j = 0;
+  for (size_t i = 0; i < extension.size ( ); ) {
+    const size_t start = i;
+    lits.clear ( );
+    for ( ; extension[i]; ++i) lits.push_back (extension[i]);
+    ++i;
+    if (taint[abs (lits[0])]) {
+      for (const int lit : lits) taint[abs (lit)] = 1;
+      original.push_back (new_clause (lits));
+      ++stats.restored;
+    } else {
+      std::copy (extension.begin ( ) + start, extension.begin ( ) + i, extension.begin ( ) + j);
+      j += i - start;
+    }
+  }
+  extension.resize (j);
+
+/* Recompute witness flags of the remaining clauses */
+  std::fill (witnesses.begin ( ), witnesses.end ( ), 0);
+  for (size_t i = 0; i < extension.size ( ); ++i) {
+    witnesses[abs (extension[i])] = 1;
+    while (extension[i]) ++i;
+  }
+}
+
+} //End namespace sat
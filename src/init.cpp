@@ -29,7 +29,6 @@ namespace sat {
 void CDCL::init_solver ( ) {
 
   srand (0);
-  init_statistics ( );
   init_parameters ( );
   init_states ( );
   init_model ( );
@@ -60,6 +59,7 @@ void CDCL::init_states ( ) {
 /*-------------------------------------------------------------------------*/
 void CDCL::init_model ( ) {
 
+  enlarge (param.vars);
   std::fill (&model[-param.vars], &model[param.vars] + 1, 0);
 }
 
@@ -68,14 +68,11 @@ void CDCL::init_model ( ) {
 /*-------------------------------------------------------------------------*/
 void CDCL::init_block ( ) {
   
-/* Initialize bmark and bskip to [0,...,0] */
-  bmark = new signed char[param.lits + 1] ( );
-  bmark += param.vars;
+/* Initialize bmark to [0,...,0] (allocated in 'enlarge') */
+  std::fill (&bmark[-param.vars], &bmark[param.vars] + 1, 0);
 
-/* Initialize bmark to [1,...,1] */
-  block = new signed char[param.lits + 1];
-  std::fill (block, block + param.lits + 1, 1);
-  block += param.vars;
+/* Initialize block to [1,...,1] */
+  std::fill (block, block + param.vars + 1, 1);
 }
 
 } //End namespace sat
\ No newline at end of file
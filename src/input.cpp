@@ -24,113 +24,180 @@
 namespace sat {
 
 /*-------------------------------------------------------------------------+
- | Read clauses from DIMACS file.                                          |
+ | Read the whole file 'file_name' into 'buffer'.                          |
+/*-------------------------------------------------------------------------*/
+bool CDCL::read_file (const std::string& file_name, std::string& buffer) {
+
+  std::ifstream file;
+  file.open (file_name.c_str ( ), std::ios::binary | std::ios::ate);
+  if (!file.is_open ( )) return false;
+  buffer.assign (file.tellg ( ), '\0');
+  file.seekg (0);
+  file.read (&buffer[0], buffer.size ( ));
+  return (bool) file;
+}
+
+/*-------------------------------------------------------------------------+
+ | Read clauses from DIMACS file. The file is read into memory at once and |
+ | then parsed by 'parse_dimacs'.                                          |
 /*-------------------------------------------------------------------------*/
 bool CDCL::read_dimacs (const std::string file_name) {
 
+  TraceScope trace ("read_dimacs");
+  if (modes.print) std::cout << "[INPUT] reading from dimacs file '" << file_name << "'" << std::endl;
+  std::string buffer;
+  if (!read_file (file_name, buffer)) {
+    std::cout << "WARNING: Failed to extract formula! File (" << file_name << ") could not be opened." << std::endl;
+    return false;
+  }
+  return parse_dimacs (buffer.data ( ), buffer.data ( ) + buffer.size ( ));
+}
+
+/*-------------------------------------------------------------------------+
+ | Parse the DIMACS formula in the buffer [begin, end).                    |
+/*-------------------------------------------------------------------------*/
+bool CDCL::parse_dimacs (const char* begin, const char* end) {
+
+  TraceScope trace ("parse_dimacs");
   assert (unit_clauses.empty ( ));
   assert (clause_lits.empty ( ));
+  assert (original.empty ( ));
+  Timer timer = phase (Stats::parse);
+  const char* p = begin;
 
-  if (modes.print) std::cout << "[INPUT] reading from dimacs file '" << file_name << "'" << std::endl;
-  auto read_start = std::chrono::high_resolution_clock::now ( );
-  std::string line;
-  std::ifstream dimacs;
-  dimacs.open (file_name.c_str ( ), std::ios::binary);
-
-  if (dimacs.is_open ( )) {
-
-  /* Skip comment lines at the beginning of file */
-    while (std::getline (dimacs, line) && line[0] == 'c');
-
-  /* Check whether header format is PWCNF */
-    if (modes.print) printf ("[INPUT] header '%s'\n", line.c_str ( ));
-    if (line[0] == 'p' && line[2] == 'c' && line[3] == 'n' && line[4] == 'f') {
-
-    /* Read header parameters */
-      line.erase (0, 6);
-      std::istringstream stream (line);
-      stream >> param.vars >> param.n_cls_start;
-      assert (param.vars > 0);
-      assert (param.n_cls_start > 0);
-      param.n_cls_start;
-
-    /* Allocate clause database */
-      assert (original.empty ( ));
-      std::vector<int> lits;
-      int ci = 0;
-      int tautologies = 0;
-
-    /* Initialize model for tautology spotting */
-      model = new int[2*param.vars + 1] ( );
-      model += param.vars;
-
-    /* Read literals from file */
-      char ch;
-      int lit;
-      bool sign;
-      dimacs.get (ch);
-      while (ch == ' ') dimacs.get (ch);
-      assert (ch == '-' || std::isdigit (ch));
-      assert (!dimacs.eof ( ));
-      for ( ; !dimacs.eof ( ); ++ci) {
-        lits.clear ( );
-        assert (ch != '0');
-        for ( ; ch != '0'; ) {
-          if (ch == '-') { sign = true; dimacs.get (ch); }
-          else sign = false;
-          assert (std::isdigit (ch));
-          lit = 0;
-          for ( ; std::isdigit (ch); dimacs.get (ch))
-            lit = 10 * lit + static_cast<int> (ch - '0');
-          if (sign) lit = -lit;
-          lits.push_back (lit);
-          while (ch == ' ') {
-            dimacs.get (ch);
-            assert (!dimacs.eof ( ));
-          }
-        }
-        assert (ch == '0');
-        dimacs.get (ch);
-        while (!dimacs.eof ( ) && !(isdigit (ch) || ch == '-'))
-          dimacs.get (ch);
-
-      /* allocate new clause */
-        if (lits.empty ( )) break;
-        const bool taut = tautology (lits);
-        if (!taut) {
-          if (lits.size ( ) == 1) {
-            unit_clauses.push_back (lits[0]);
-          } else {
-            Clause* c = new_clause (lits);
-            original.push_back (c);
-            assert (!lits.empty ( ));
-          }
-        }
-      }
+/* Skip comment lines at the beginning of file */
+  while (p != end && *p == 'c')
+    while (p != end && *p++ != '\n');
+
+/* Check whether header format is CNF */
+  const char* line = p;
+  while (p != end && *p != '\n') ++p;
+  if (modes.print) printf ("[INPUT] header '%s'\n", std::string (line, p).c_str ( ));
+  if (p - line < 5 || line[0] != 'p' || line[2] != 'c' || line[3] != 'n' || line[4] != 'f') {
+    std::cout << "WARNING : Error in CNF format header. Could not read pwcnf header." << std::endl;
+    return false;
+  }
+
+/* Read header parameters */
+  std::istringstream stream (std::string (line + 5, p));
+  stream >> param.vars >> param.n_cls_start;
+  if (param.vars < 0 || param.n_cls_start < 0) {
+    std::cout << "WARNING : Error in CNF format header. Negative parameters." << std::endl;
+    return false;
+  }
 
-    /* Handle insufficient / excess clauses */
-      if (ci < param.n_cls_start) {
-        std::cout << "[INPUT] WARNING: Found " << ci << "clauses: Expected " << param.n_cls_start << std::endl;
-        assert (false);
-      } else if (ci > param.n_cls_start) {
-        //int clause_count = param.n_cls_start;
-        //while (std::getline (dimacs, line)) ++clause_count;
-        std::cout << "[INPUT] WARNING: Found " << ci << " clauses. Truncating to " << param.n_cls_start << " clauses." << std::endl;
-        assert (false);
+/* Initialize model for tautology spotting */
+  enlarge (param.vars);
+
+/* Read literals. The number 0 ends a clause. Variables beyond the header
+   would be out of the bounds of 'model' and 'bmark'. */
+  tokenize (p, end, dimacs_numbers);
+  std::vector<int> lits;
+  int ci = 0;
+  for (const int lit : dimacs_numbers) {
+    if (lit > param.vars || lit < -param.vars) {
+      std::cout << "WARNING : Error in CNF format. Literal " << lit << " exceeds " << param.vars << " variables." << std::endl;
+      return false;
+    }
+    if (lit) { lits.push_back (lit); continue; }
+    ++ci;
+
+  /* allocate new clause */
+    if (lits.empty ( )) state.inconsistent = true;
+    else if (!tautology (lits)) {
+      if (lits.size ( ) == 1) {
+        unit_clauses.push_back (lits[0]);
+      } else {
+        Clause* c = new_clause (lits, false);
+        original.push_back (c);
       }
-      dimacs.close ( );
-      auto read_end = std::chrono::high_resolution_clock::now ( );
-      //std::cout << "TIME (read) : " <<  std::chrono::duration<double>(read_end - read_start).count ( ) << std::endl;
-      return true;
     }
-  /* Error in format */
-    std::cout << "WARNING : Error in CNF format header. Could not read pwcnf header." << std::endl;
-    dimacs.close ( );
+    lits.clear ( );
+  }
+  if (!lits.empty ( )) {
+    std::cout << "[INPUT] WARNING: Last clause is not terminated by 0" << std::endl;
+    return false;
+  }
+
+/* Handle insufficient / excess clauses */
+  if (ci < param.n_cls_start) {
+    std::cout << "[INPUT] WARNING: Found " << ci << " clauses: Expected " << param.n_cls_start << std::endl;
     return false;
+  } else if (ci > param.n_cls_start) {
+    std::cout << "[INPUT] WARNING: Found " << ci << " clauses: Expected " << param.n_cls_start << std::endl;
+    return false;
+  }
+  timer.stop ( );
+
+/* Compute clause signatures (timed separately from parsing) */
+  Timer signature = phase (Stats::signature);
+  for (Clause* c : original)
+    compute_hash (c);
+  return true;
+}
+
+/*-------------------------------------------------------------------------+
+ | Tokenize the bytes [p, stop) one by one (continuing past 'stop' to the  |
+ | end of a number or a comment line). Returns the position reached.       |
+/*-------------------------------------------------------------------------*/
+static const char* tokenize_bytes (const char* p, const char* stop, const char* begin, const char* end,
+                                   std::vector<int>& numbers) {
+
+  while (p < stop) {
+    if (*p == 'c' && p != begin && p[-1] == '\n') {          // comment line
+      while (p != end && *p != '\n') ++p;
+      continue;
+    }
+    if (!std::isdigit (*p)) { ++p; continue; }
+    const bool sign = p != begin && p[-1] == '-';
+    int lit = 0;
+    while (p != end && std::isdigit (*p))
+      lit = 10 * lit + static_cast<int> (*p++ - '0');
+    numbers.push_back (sign ? -lit : lit);
   }
-/* Return failure */
-  std::cout << "WARNING: Failed to extract formula! File (" << file_name << ") could not be opened." << std::endl;
-  return false;
+  return p;
+}
+
+/*-------------------------------------------------------------------------+
+ | Split the DIMACS body [begin, end) into its numbers. Each number ends   |
+ | at the first non-digit character and is negative if directly preceded   |
+ | by '-'. A line starting with 'c' is a comment. Blocks of 64 bytes are   |
+ | classified at once by the kernel 'classify' (see 'kernels.h'): numbers  |
+ | start at digits without a digit before and end at digits without one    |
+ | after. A number reaching the end of a block is left to the next block.  |
+ | Blocks which may contain a comment and the tail are read byte by byte.  |
+ | A line starting with '%' ends the formula (as in the SATLIB trailer     |
+ | '%' '0'), so both paths stop there.                                     |
+/*-------------------------------------------------------------------------*/
+void CDCL::tokenize (const char* begin, const char* end, std::vector<int>& numbers) {
+
+  numbers.clear ( );
+  for (const char* q = begin; (q = (const char*) memchr (q, '%', end - q)); ++q)
+    if (q == begin || q[-1] == '\n') { end = q; break; }
+  const char* p = begin;
+  while (end - p >= 64) {
+    uint64_t digits, comments;
+    kernels ( ).classify (p, digits, comments);
+    if (comments || !~digits) { p = tokenize_bytes (p, p + 64, begin, end, numbers); continue; }
+    int length = 64;
+    if (digits >> 63) {                         // defer number at the end
+      length = 64 - __builtin_clzll (~digits);
+      digits &= (1ULL << length) - 1;
+    }
+    uint64_t starts = digits & ~(digits << 1);
+    uint64_t ends = digits & ~(digits >> 1);
+    for ( ; starts; starts &= starts - 1, ends &= ends - 1) {
+      const char* q = p + __builtin_ctzll (starts);
+      const char* last = p + __builtin_ctzll (ends);
+      const bool sign = q != begin && q[-1] == '-';
+      int lit = 0;
+      for ( ; q <= last; ++q)
+        lit = 10 * lit + static_cast<int> (*q - '0');
+      numbers.push_back (sign ? -lit : lit);
+    }
+    p += length;
+  }
+  tokenize_bytes (p, end, begin, end, numbers);
 }
 
 /*-------------------------------------------------------------------------+
@@ -153,4 +220,78 @@ bool CDCL::tautology (std::vector<int>& lits) {
   return taut;
 }
 
+/*-------------------------------------------------------------------------+
+ | Add the clause 'lits[0], ..., lits[size - 1]' to the formula without    |
+ | going through a DIMACS file. Tautologies are dropped and duplicated     |
+ | literals removed in the same way as in 'read_dimacs'.                   |
+/*-------------------------------------------------------------------------*/
+void CDCL::add_clause (const int* lits, const size_t size) {
+
+/* Copy literals and grow variable containers if needed */
+  add_lits.assign (lits, lits + size);
+  for (const int lit : add_lits) {
+    assert (lit);
+    if (abs (lit) > param.vars) param.vars = abs (lit);
+  }
+  enlarge (param.vars);
+  ++param.n_cls_start;
+
+/* Allocate new clause */
+  if (tautology (add_lits)) return;
+  if (add_lits.empty ( )) state.inconsistent = true;
+  else if (add_lits.size ( ) == 1) unit_clauses.push_back (add_lits[0]);
+  else original.push_back (new_clause (add_lits));
+}
+
+/*-------------------------------------------------------------------------+
+ | Add all clauses of the flat buffer 'lits[0], ..., lits[size - 1]' in    |
+ | which each clause is terminated by 0 (as in DIMACS).                    |
+/*-------------------------------------------------------------------------*/
+void CDCL::add_clauses (const int* lits, const size_t size) {
+
+  const int* end = lits + size;
+  const int* begin = lits;
+  for (const int* p = lits; p != end; ++p) {
+    if (*p) continue;
+    add_clause (begin, p - begin);
+    begin = p + 1;
+  }
+  if (begin != end) add_clause (begin, end - begin);
+}
+
+/*-------------------------------------------------------------------------+
+ | Grow the variable indexed containers 'model', 'bmark' and 'block' so    |
+ | that they hold at least 'vars' variables. 'model' and 'bmark' are all   |
+ | zero in between calls, so only 'block' (which persists in incremental   |
+ | mode) has to be copied.                                                 |
+/*-------------------------------------------------------------------------*/
+void CDCL::enlarge (const int vars) {
+
+  if (model && vars <= param.vars_alloc) return;
+  const int alloc = std::max (vars, 2*param.vars_alloc);
+
+/* Allocate new containers */
+  signed char* new_block = new signed char[alloc + 1];
+  std::fill (new_block, new_block + alloc + 1, 1);
+
+/* Release old containers */
+  if (model) {
+    std::copy (block, block + param.vars_alloc + 1, new_block);
+    model -= param.vars_alloc;
+    delete [] model;
+    bmark -= param.vars_alloc;
+    delete [] bmark;
+    delete [] block;
+  }
+  model = new int[2*alloc + 1] ( );
+  model += alloc;
+  bmark = new signed char[2*alloc + 1 + kernel_mark_padding] ( );
+  bmark += alloc;
+  block = new_block;
+  frozentab.resize (alloc + 1, 0);
+  witnesses.resize (alloc + 1, 0);
+  dirty.resize (alloc + 1, 0);
+  param.vars_alloc = alloc;
+}
+
 } //End namespace sat
\ No newline at end of file
@@ -0,0 +1,350 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+#include <climits>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+
+#include "kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SAT_X86 1
+#include <immintrin.h>
+#define SSE2   __attribute__ ((target ("sse2")))
+#define AVX2   __attribute__ ((target ("avx2")))
+#define AVX512 __attribute__ ((target ("avx512f,avx512bw,avx512vl")))
+#else
+#define SAT_X86 0
+#endif
+
+namespace sat {
+
+/*-------------------------------------------------------------------------+
+ | Portable versions (the reference for all other tiers).                  |
+/*-------------------------------------------------------------------------*/
+static uint64_t signature_mask_scalar (const OccrsHash* occs, const size_t n, const uint64_t hash, const uint64_t unique) {
+
+  uint64_t mask = 0;
+  for (size_t i = 0; i < n; ++i)
+    mask |= (uint64_t) !((occs[i].hash & hash) | (occs[i].unique & unique)) << i;
+  return mask;
+}
+
+static void clause_hash_scalar (const int* lits, const int size, uint64_t& hash, uint64_t& unique) {
+
+  uint64_t h = 0, u = 0;
+  for (int i = 0; i < size; ++i) {
+    const uint64_t x = 1ULL << (abs (lits[i]) & 63);
+    u |= h & x;                               // collision signature - u(C)
+    h |= x;                                   // clause signature    - h(C)
+  }
+  hash = h, unique = u;
+}
+
+static int subsumed_scalar (const signed char* marks, const int* lits, const int size) {
+
+  int str = 0;
+  for (int i = 0; i < size; ++i) {
+    const int lit = lits[i];
+    const signed char sign = marks[lit];
+    if (!sign) return 0;                      // 'lit' unmarked
+    else if (sign > 0) continue;              // 'lit' mark is positive
+    else if (str) return 0;                   // two negated literals
+    else str = lit;                           // strengthening literal
+  }
+  return str ? str : INT_MIN;
+}
+
+static void classify_scalar (const char* p, uint64_t& digits, uint64_t& comments) {
+
+  uint64_t d = 0, c = 0;
+  for (int i = 0; i < 64; ++i) {
+    d |= (uint64_t) ((unsigned char) (p[i] - '0') < 10) << i;
+    c |= (uint64_t) (p[i] == 'c') << i;
+  }
+  digits = d, comments = c;
+}
+
+#if SAT_X86
+
+static_assert (offsetof (OccrsHash, unique) == offsetof (OccrsHash, hash) + 8, "signatures must be adjacent");
+static_assert (sizeof (OccrsHash) == 32, "gather offsets assume 32 byte occurrences");
+
+/*-------------------------------------------------------------------------+
+ | SSE2 (every x86-64 CPU): both signatures of an entry in one register.   |
+/*-------------------------------------------------------------------------*/
+SSE2 static uint64_t signature_mask_sse2 (const OccrsHash* occs, const size_t n, const uint64_t hash, const uint64_t unique) {
+
+  const __m128i mask = _mm_set_epi64x (unique, hash);
+  const __m128i zero = _mm_setzero_si128 ( );
+  uint64_t result = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const __m128i v = _mm_and_si128 (_mm_loadu_si128 ((const __m128i*) &occs[i].hash), mask);
+    result |= (uint64_t) (_mm_movemask_epi8 (_mm_cmpeq_epi8 (v, zero)) == 0xFFFF) << i;
+  }
+  return result;
+}
+
+SSE2 static void classify_sse2 (const char* p, uint64_t& digits, uint64_t& comments) {
+
+  const __m128i shift = _mm_set1_epi8 ((char) (0x80 - '0'));    // digits to -128, ..., -119
+  const __m128i limit = _mm_set1_epi8 (-118);
+  const __m128i c = _mm_set1_epi8 ('c');
+  uint64_t d = 0, m = 0;
+  for (int i = 0; i < 64; i += 16) {
+    const __m128i v = _mm_loadu_si128 ((const __m128i*) (p + i));
+    d |= (uint64_t) (uint16_t) _mm_movemask_epi8 (_mm_cmplt_epi8 (_mm_add_epi8 (v, shift), limit)) << i;
+    m |= (uint64_t) (uint16_t) _mm_movemask_epi8 (_mm_cmpeq_epi8 (v, c)) << i;
+  }
+  digits = d, comments = m;
+}
+
+/*-------------------------------------------------------------------------+
+ | AVX2: four occurrences (gathered) or eight literals at a time.          |
+/*-------------------------------------------------------------------------*/
+AVX2 static uint64_t signature_mask_avx2 (const OccrsHash* occs, const size_t n, const uint64_t hash, const uint64_t unique) {
+
+  const __m256i h = _mm256_set1_epi64x (hash);
+  const __m256i u = _mm256_set1_epi64x (unique);
+  const __m256i hidx = _mm256_setr_epi64x (1, 5, 9, 13);       // 'hash' of four entries (in words)
+  const __m256i uidx = _mm256_setr_epi64x (2, 6, 10, 14);       // 'unique' of four entries
+  const __m256i zero = _mm256_setzero_si256 ( );
+  uint64_t result = 0;
+  size_t i = 0;
+  for ( ; i + 4 <= n; i += 4) {
+    const long long* base = (const long long*) (occs + i);
+    const __m256i hs = _mm256_i64gather_epi64 (base, hidx, 8);
+    const __m256i us = _mm256_i64gather_epi64 (base, uidx, 8);
+    const __m256i t = _mm256_or_si256 (_mm256_and_si256 (hs, h), _mm256_and_si256 (us, u));
+    result |= (uint64_t) _mm256_movemask_pd (_mm256_castsi256_pd (_mm256_cmpeq_epi64 (t, zero))) << i;
+  }
+  if (i < n) result |= signature_mask_scalar (occs + i, n - i, hash, unique) << i;    // no shift by 64
+  return result;
+}
+
+AVX2 static void clause_hash_avx2 (const int* lits, const int size, uint64_t& hash, uint64_t& unique) {
+
+  if (size < 8) { clause_hash_scalar (lits, size, hash, unique); return; }
+  const __m256i one = _mm256_set1_epi64x (1);
+  const __m256i bits = _mm256_set1_epi64x (63);
+  __m256i h = _mm256_setzero_si256 ( ), u = h;
+  int i = 0;
+  for ( ; i + 4 <= size; i += 4) {
+    const __m128i l = _mm_abs_epi32 (_mm_loadu_si128 ((const __m128i*) (lits + i)));
+    const __m256i x = _mm256_sllv_epi64 (one, _mm256_and_si256 (_mm256_cvtepi32_epi64 (l), bits));
+    u = _mm256_or_si256 (u, _mm256_and_si256 (h, x));
+    h = _mm256_or_si256 (h, x);
+  }
+
+/* Combine the lanes (bits set in two lanes collide) and the rest */
+  alignas (32) uint64_t hs[4], us[4];
+  _mm256_store_si256 ((__m256i*) hs, h);
+  _mm256_store_si256 ((__m256i*) us, u);
+  uint64_t hh = 0, uu = 0;
+  for (int j = 0; j < 4; ++j) { uu |= us[j] | (hh & hs[j]); hh |= hs[j]; }
+  for ( ; i < size; ++i) {
+    const uint64_t x = 1ULL << (abs (lits[i]) & 63);
+    uu |= hh & x;
+    hh |= x;
+  }
+  hash = hh, unique = uu;
+}
+
+AVX2 static int subsumed_avx2 (const signed char* marks, const int* lits, const int size) {
+
+  if (size < 16) return subsumed_scalar (marks, lits, size);
+  const __m256i zero = _mm256_setzero_si256 ( );
+  int str = 0;
+  int i = 0;
+  for ( ; i + 8 <= size; i += 8) {
+    const __m256i l = _mm256_loadu_si256 ((const __m256i*) (lits + i));
+    __m256i m = _mm256_i32gather_epi32 ((const int*) marks, l, 1);    // mark in the lowest byte
+    m = _mm256_srai_epi32 (_mm256_slli_epi32 (m, 24), 24);
+    if (_mm256_movemask_ps (_mm256_castsi256_ps (_mm256_cmpeq_epi32 (m, zero)))) return 0;
+    const int negative = _mm256_movemask_ps (_mm256_castsi256_ps (m));
+    if (!negative) continue;
+    if (str || (negative & (negative - 1))) return 0;
+    str = lits[i + __builtin_ctz (negative)];
+  }
+  const int rest = subsumed_scalar (marks, lits + i, size - i);
+  if (!rest) return 0;
+  if (rest == INT_MIN) return str ? str : INT_MIN;
+  return str ? 0 : rest;
+}
+
+AVX2 static void classify_avx2 (const char* p, uint64_t& digits, uint64_t& comments) {
+
+  const __m256i shift = _mm256_set1_epi8 ((char) (0x80 - '0'));
+  const __m256i limit = _mm256_set1_epi8 (-118);
+  const __m256i c = _mm256_set1_epi8 ('c');
+  uint64_t d = 0, m = 0;
+  for (int i = 0; i < 64; i += 32) {
+    const __m256i v = _mm256_loadu_si256 ((const __m256i*) (p + i));
+    d |= (uint64_t) (uint32_t) _mm256_movemask_epi8 (_mm256_cmpgt_epi8 (limit, _mm256_add_epi8 (v, shift))) << i;
+    m |= (uint64_t) (uint32_t) _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (v, c)) << i;
+  }
+  digits = d, comments = m;
+}
+
+/*-------------------------------------------------------------------------+
+ | AVX-512: eight occurrences or sixteen literals at a time, with masks    |
+ | for the rest.                                                           |
+/*-------------------------------------------------------------------------*/
+AVX512 static uint64_t signature_mask_avx512 (const OccrsHash* occs, const size_t n, const uint64_t hash, const uint64_t unique) {
+
+  const __m512i h = _mm512_set1_epi64 (hash);
+  const __m512i u = _mm512_set1_epi64 (unique);
+  const __m512i hidx = _mm512_setr_epi64 (1, 5, 9, 13, 17, 21, 25, 29);
+  const __m512i uidx = _mm512_setr_epi64 (2, 6, 10, 14, 18, 22, 26, 30);
+  const __m512i zero = _mm512_setzero_si512 ( );
+  uint64_t result = 0;
+  for (size_t i = 0; i < n; i += 8) {
+    const __mmask8 k = n - i >= 8 ? 0xFF : (1u << (n - i)) - 1;
+    const long long* base = (const long long*) (occs + i);
+    const __m512i hs = _mm512_mask_i64gather_epi64 (zero, k, hidx, base, 8);
+    const __m512i us = _mm512_mask_i64gather_epi64 (zero, k, uidx, base, 8);
+    const __m512i t = _mm512_or_si512 (_mm512_and_si512 (hs, h), _mm512_and_si512 (us, u));
+    result |= (uint64_t) _mm512_mask_testn_epi64_mask (k, t, t) << i;
+  }
+  return result;
+}
+
+AVX512 static void clause_hash_avx512 (const int* lits, const int size, uint64_t& hash, uint64_t& unique) {
+
+  if (size < 16) { clause_hash_scalar (lits, size, hash, unique); return; }
+  const __m512i one = _mm512_set1_epi64 (1);
+  const __m512i bits = _mm512_set1_epi64 (63);
+  __m512i h = _mm512_setzero_si512 ( ), u = h;
+  int i = 0;
+  for ( ; i + 8 <= size; i += 8) {
+    const __m256i l = _mm256_abs_epi32 (_mm256_loadu_si256 ((const __m256i*) (lits + i)));
+    const __m512i x = _mm512_sllv_epi64 (one, _mm512_and_si512 (_mm512_cvtepi32_epi64 (l), bits));
+    u = _mm512_or_si512 (u, _mm512_and_si512 (h, x));
+    h = _mm512_or_si512 (h, x);
+  }
+  alignas (64) uint64_t hs[8], us[8];
+  _mm512_store_si512 (hs, h);
+  _mm512_store_si512 (us, u);
+  uint64_t hh = 0, uu = 0;
+  for (int j = 0; j < 8; ++j) { uu |= us[j] | (hh & hs[j]); hh |= hs[j]; }
+  for ( ; i < size; ++i) {
+    const uint64_t x = 1ULL << (abs (lits[i]) & 63);
+    uu |= hh & x;
+    hh |= x;
+  }
+  hash = hh, unique = uu;
+}
+
+AVX512 static int subsumed_avx512 (const signed char* marks, const int* lits, const int size) {
+
+  if (size < 16) return subsumed_scalar (marks, lits, size);
+  const __m512i zero = _mm512_setzero_si512 ( );
+  int str = 0;
+  for (int i = 0; i < size; i += 16) {
+    const __mmask16 k = size - i >= 16 ? 0xFFFF : (1u << (size - i)) - 1;
+    const __m512i l = _mm512_maskz_loadu_epi32 (k, lits + i);
+    __m512i m = _mm512_mask_i32gather_epi32 (zero, k, l, marks, 1);
+    m = _mm512_srai_epi32 (_mm512_slli_epi32 (m, 24), 24);
+    if (_mm512_mask_cmpeq_epi32_mask (k, m, zero)) return 0;
+    const unsigned negative = _mm512_mask_cmplt_epi32_mask (k, m, zero);
+    if (!negative) continue;
+    if (str || (negative & (negative - 1))) return 0;
+    str = lits[i + __builtin_ctz (negative)];
+  }
+  return str ? str : INT_MIN;
+}
+
+AVX512 static void classify_avx512 (const char* p, uint64_t& digits, uint64_t& comments) {
+
+  const __m512i v = _mm512_loadu_si512 (p);
+  digits = _mm512_cmplt_epu8_mask (_mm512_sub_epi8 (v, _mm512_set1_epi8 ('0')), _mm512_set1_epi8 (10));
+  comments = _mm512_cmpeq_epi8_mask (v, _mm512_set1_epi8 ('c'));
+}
+
+#endif
+
+/*-------------------------------------------------------------------------+
+ | Tiers from best to worst and startup selection.                         |
+/*-------------------------------------------------------------------------*/
+static const Kernels scalar_kernels = { "scalar", signature_mask_scalar, clause_hash_scalar, subsumed_scalar, classify_scalar };
+#if SAT_X86
+static const Kernels sse2_kernels   = { "sse2", signature_mask_sse2, clause_hash_scalar, subsumed_scalar, classify_sse2 };
+static const Kernels avx2_kernels   = { "avx2", signature_mask_avx2, clause_hash_avx2, subsumed_avx2, classify_avx2 };
+static const Kernels avx512_kernels = { "avx512", signature_mask_avx512, clause_hash_avx512, subsumed_avx512, classify_avx512 };
+static const Kernels* tiers[] = { &avx512_kernels, &avx2_kernels, &sse2_kernels, &scalar_kernels };
+#else
+static const Kernels* tiers[] = { &scalar_kernels };
+#endif
+
+const Kernels* active_kernels = &scalar_kernels;
+
+static bool supported (const Kernels* kernels) {
+
+#if SAT_X86
+  __builtin_cpu_init ( );
+  if (kernels == &avx512_kernels)
+    return __builtin_cpu_supports ("avx512f") && __builtin_cpu_supports ("avx512bw") && __builtin_cpu_supports ("avx512vl");
+  if (kernels == &avx2_kernels) return __builtin_cpu_supports ("avx2");
+  if (kernels == &sse2_kernels) return __builtin_cpu_supports ("sse2");
+#endif
+  return kernels == &scalar_kernels;
+}
+
+/*-------------------------------------------------------------------------+
+ | Use the tier 'name'. Returns false if the CPU does not support it.      |
+/*-------------------------------------------------------------------------*/
+bool select_kernels (const std::string& name) {
+
+  for (const Kernels* kernels : tiers)
+    if (name == kernels->name && supported (kernels)) {
+      active_kernels = kernels;
+      return true;
+    }
+  return false;
+}
+
+/*-------------------------------------------------------------------------+
+ | Names of the tiers supported by the CPU (best first).                   |
+/*-------------------------------------------------------------------------*/
+std::vector<std::string> available_kernels ( ) {
+
+  std::vector<std::string> names;
+  for (const Kernels* kernels : tiers)
+    if (supported (kernels)) names.push_back (kernels->name);
+  return names;
+}
+
+/*-------------------------------------------------------------------------+
+ | Select the best tier at startup ('SAT_KERNELS=<tier>' overrides).       |
+/*-------------------------------------------------------------------------*/
+static struct KernelSelection {
+  KernelSelection ( ) {
+    const char* name = getenv ("SAT_KERNELS");
+    if (name && *name) {
+      if (select_kernels (name)) return;
+      std::cout << "WARNING: kernels '" << name << "' not supported by this CPU" << std::endl;
+    }
+    select_kernels (available_kernels ( ).front ( ));
+  }
+} kernel_selection;
+
+} //End namespace sat
@@ -0,0 +1,79 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+/*-------- General includes ----------------------------------------*/
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*-------- Header Includes --------------------------------------*/
+#include "signature.h"
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+namespace sat {
+
+/*-------------------------------------------------------------------------+
+ | Hot kernels in several versions for instruction set tiers ('scalar',    |
+ | 'sse2', 'avx2' and 'avx512'). The best tier supported by the CPU is     |
+ | selected once at startup (through cpuid), so one portable binary runs   |
+ | the vector code wherever it is available. A tier can be forced with the |
+ | environment variable 'SAT_KERNELS' or with 'select_kernels' (only       |
+ | before solving, for tests and benchmarks). All tiers compute exactly    |
+ | the same results (see 'test/differential.cpp').                         |
+/*-------------------------------------------------------------------------*/
+struct Kernels {
+
+  const char* name;
+
+/* Bit i is set if 'occs[i]' has no signature bit in common with 'hash'
+   and 'unique' (for n <= 64 entries). With '~c->hash'/'~c->unique' these
+   are the subsumption candidates of 'c' (see 'subsume_candidate'), with
+   pivot masked signatures the surely non-tautological resolvents (see
+   'resolvent_disjoint'). */
+  uint64_t (*signature_mask) (const OccrsHash* occs, const size_t n, const uint64_t hash, const uint64_t unique);
+
+/* Signature of the literals 'lits[0], ..., lits[size - 1]' (see
+   'compute_hash') */
+  void (*clause_hash) (const int* lits, const int size, uint64_t& hash, uint64_t& unique);
+
+/* Check of the literals 'lits' against the sign marks 'marks' (see
+   'subsumed') */
+  int (*subsumed) (const signed char* marks, const int* lits, const int size);
+
+/* Masks of the digits and of the character 'c' in the 64 bytes at 'p'
+   (see 'tokenize') */
+  void (*classify) (const char* p, uint64_t& digits, uint64_t& comments);
+};
+
+extern const Kernels* active_kernels;
+
+inline const Kernels& kernels ( ) { return *active_kernels; }
+bool select_kernels (const std::string& name);
+std::vector<std::string> available_kernels ( );
+
+/* Kernels read this many bytes past the last mark ('CDCL::bmark') */
+static const int kernel_mark_padding = 3;
+
+} //End namespace sat
+
+#endif
@@ -32,9 +32,24 @@ struct Limits {
 
   const int      block_max_cls_size   = 1e3;
   const int      block_max_noccs      = 1e3;
+  const int      block_cover_size_max = 1e2;
   const int      elim_res_size_max    = 1e4;
   const int      elim_occrs_max       = 1e3;
+  const int      elim_xor_size_max    =   5;
   const int      subsume_max_cls_size = 1e3;
+  const int      subsume_merge_size   =  64;
+  const long     subsume_merge_marks  = 1L << 20;
+
+/* Effort budgets in ticks (see 'Budget'), 0 for none. 'ticks' bounds a
+   whole call of 'solve' or 'simplify', of which each technique may use
+   at most its share. Wall-clock time is bounded by 'modes.timeout'. */
+  long           ticks                = 0;
+  long           subsume_ticks        = 0;
+  long           block_ticks          = 0;
+  long           elim_ticks           = 0;
+  double         subsume_share        = 1;
+  double         block_share          = 1;
+  double         elim_share           = 1;
 };
 
 #endif
\ No newline at end of file
@@ -30,13 +30,21 @@ struct Modes {
   ~Modes ( ) { }
   Modes ( ) { }
   
+  bool adaptive     = false;                    // choose signatures per list (see 'Adaptive')
+  bool apply        = false;
   bool block        =  true;
+  bool cover        = false;                    // covered / asymmetric BCE (see 'block_cover')
   bool elim         = false;
+  bool gates        =  true;                    // gate definitions in BVE (see 'elim_find_gate')
   bool hash         = false;
+  bool incremental  = false;
+  bool perf         = false;
   bool print        =     0;
   bool subsume      = false;
+  bool substitute   = false;                    // equivalent literal substitution (see 'substitute.cpp')
   int  verb         =     1;
-  double  timeout   = 10000;
+  int  merge        =    -1;                    // clause size from which subsumption merges (see 'subsumed'), -1 adaptive, 0 never
+  double  timeout   = 10000;                    // seconds per call (see 'Budget')
 };
 
 #endif
\ No newline at end of file
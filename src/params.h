@@ -39,6 +39,10 @@ struct Params {
   int    lits              =       0;
   int    n_cls_start       =       0;
   int    original          =       0;
+  int    vars_alloc        =       0;
+  int    garbage           =       0;
+  int    units             =       0;
+  int    merge_size        =       0;   // size from which subsumption merges (see 'subsume_merge_size')
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,113 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+#include <algorithm>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "perf.h"
+
+namespace sat {
+
+/*-------------------------------------------------------------------------+
+ | Open one counter per event. Kernel and hypervisor events are excluded,  |
+ | which is all that 'perf_event_paranoid' = 2 allows.                     |
+/*-------------------------------------------------------------------------*/
+void Perf::open ( ) {
+
+  const uint64_t events[4] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                               PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+  for (int i = 0; i < 4; ++i) {
+    perf_event_attr attr;
+    memset (&attr, 0, sizeof attr);
+    attr.size = sizeof attr;
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = events[i];
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fds[i] = syscall (SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  }
+  opened = true;
+}
+
+/*-------------------------------------------------------------------------+
+ | Close all counters.                                                     |
+/*-------------------------------------------------------------------------*/
+void Perf::close ( ) {
+
+  for (int& fd : fds) {
+    if (fd >= 0) ::close (fd);
+    fd = -1;
+  }
+  opened = false;
+}
+
+/*-------------------------------------------------------------------------+
+ | Read the current counts. Returns false if no counter is available.      |
+/*-------------------------------------------------------------------------*/
+bool Perf::read (Hardware& counts) {
+
+  if (!opened) open ( );
+  long* values[4] = { &counts.cycles, &counts.instructions, &counts.cache_misses, &counts.branch_misses };
+  bool available = false;
+  for (int i = 0; i < 4; ++i) {
+    uint64_t value;
+    if (fds[i] >= 0 && ::read (fds[i], &value, sizeof value) == sizeof value) {
+      *values[i] = value;
+      available = true;
+    } else *values[i] = -1;
+  }
+  return available;
+}
+
+/*-------------------------------------------------------------------------+
+ | Start timing 'phase'.                                                   |
+/*-------------------------------------------------------------------------*/
+Timer::Timer (Stats& stats_, const Stats::Phase phase_, Perf* perf_) :
+  stats {&stats_}, phase {phase_}, perf {perf_} {
+
+  if (perf && !perf->read (begin)) perf = 0;
+  start = std::chrono::steady_clock::now ( );
+}
+
+/*-------------------------------------------------------------------------+
+ | Stop timing and add the elapsed time and events to 'stats'.             |
+/*-------------------------------------------------------------------------*/
+void Timer::stop ( ) {
+
+  if (!stats) return;
+  stats->time[phase] += std::chrono::duration<double> (std::chrono::steady_clock::now ( ) - start).count ( );
+  Hardware end;
+  if (perf && perf->read (end)) {
+    Hardware& total = stats->hardware[phase];
+    long* totals[4] = { &total.cycles, &total.instructions, &total.cache_misses, &total.branch_misses };
+    const long begins[4] = { begin.cycles, begin.instructions, begin.cache_misses, begin.branch_misses };
+    const long ends[4] = { end.cycles, end.instructions, end.cache_misses, end.branch_misses };
+    for (int i = 0; i < 4; ++i)
+      if (begins[i] >= 0 && ends[i] >= 0)
+        *totals[i] = std::max (*totals[i], 0L) + ends[i] - begins[i];
+  }
+  stats = 0;
+}
+
+} //End namespace sat
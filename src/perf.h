@@ -0,0 +1,90 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+
+/*-------- General includes ----------------------------------------*/
+#include <chrono>
+#include <vector>
+
+/*-------- Header Includes --------------------------------------*/
+#include "stats.h"
+
+#ifndef PERF_H
+#define PERF_H
+
+namespace sat {
+
+/*-------------------------------------------------------------------------+
+ | Hardware performance counters (cycles, instructions, last level cache   |
+ | misses and branch misses) of the calling thread read through            |
+ | perf_event_open. The counters are opened on the first 'read' by the     |
+ | thread that uses the solver. Counters which cannot be opened, for       |
+ | instance in containers or with a restrictive 'perf_event_paranoid', are |
+ | reported as -1 and all others keep working.                             |
+/*-------------------------------------------------------------------------*/
+class Perf {
+
+  public:
+
+    Perf ( ) { }
+    ~Perf ( ) { close ( ); }
+    Perf (const Perf&) = delete;
+    Perf& operator= (const Perf&) = delete;
+
+    bool read (Hardware& counts);
+
+  private:
+
+    void open ( );
+    void close ( );
+
+    int fds[4] = { -1, -1, -1, -1 };         // cycles, instructions, cache misses, branch misses
+    bool opened = false;                     // tried to open the counters
+};
+
+/*-------------------------------------------------------------------------+
+ | Adds the time between its construction and destruction (or 'stop') to   |
+ | 'stats.time[phase]' and, if 'perf' is given, the hardware events in     |
+ | between to 'stats.hardware[phase]'.                                     |
+/*-------------------------------------------------------------------------*/
+class Timer {
+
+  public:
+
+    Timer (Stats& stats_, const Stats::Phase phase_, Perf* perf_ = 0);
+    ~Timer ( ) { stop ( ); }
+    Timer (const Timer&) = delete;
+    Timer& operator= (const Timer&) = delete;
+
+    void stop ( );
+
+  private:
+
+    Stats* stats;                            // statistics (0 once stopped)
+    Stats::Phase phase;                      // timed phase
+    Perf* perf;                              // hardware counters (optional)
+    Hardware begin;                          // counts at construction
+    std::chrono::steady_clock::time_point start;
+};
+
+} //End namespace sat
+
+#endif
@@ -0,0 +1,182 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+#include <sys/resource.h>
+
+#include "report.h"
+
+namespace sat {
+
+/*-------------------------------------------------------------------------+
+ | Record the bytes held by the clause store, the occurrence lists and the |
+ | variable indexed mark arrays in 'stats'. Called at the end of 'solve'   |
+ | and 'simplify', before the formula is released.                         |
+/*-------------------------------------------------------------------------*/
+void CDCL::measure_memory ( ) {
+
+/* Clause store (clauses, units and the extension stack) */
+  size_t clauses = original.capacity ( ) * sizeof (Clause*);
+  clauses += (unit_clauses.capacity ( ) + extension.capacity ( )) * sizeof (int);
+  for (const Clause* c : original)
+    clauses += sizeof (Clause) + (c->size ( ) - 2) * sizeof (int);
+  stats.bytes_clauses = clauses;
+
+/* Occurrence lists (with and without signatures) */
+  size_t occurrences = occrs.capacity ( ) * sizeof (std::vector<Clause*>);
+  occurrences += occrshash.capacity ( ) * sizeof (std::vector<OccrsHash>);
+  occurrences += ohu.capacity ( ) * sizeof (std::vector<std::pair<uint64_t, uint64_t>>);
+  for (const auto& occs : occrs) occurrences += occs.capacity ( ) * sizeof (Clause*);
+  for (const auto& occs : occrshash) occurrences += occs.capacity ( ) * sizeof (OccrsHash);
+  for (const auto& occs : ohu) occurrences += occs.capacity ( ) * sizeof (std::pair<uint64_t, uint64_t>);
+  stats.bytes_occurrences = occurrences;
+
+/* Marks ('model', 'bmark', 'block' and the incremental containers) */
+  size_t marks = 0;
+  if (model) {
+    const size_t alloc = param.vars_alloc;
+    marks += (2*alloc + 1) * (sizeof (int) + sizeof (signed char)) + (alloc + 1) * sizeof (signed char);
+  }
+  marks += frozentab.capacity ( ) * sizeof (int) + witnesses.capacity ( ) + dirty.capacity ( );
+  marks += dirty_vars.capacity ( ) * sizeof (int);
+  stats.bytes_marks = marks;
+}
+
+/*-------------------------------------------------------------------------+
+ | Peak resident set size of the process in bytes.                         |
+/*-------------------------------------------------------------------------*/
+size_t Report::peak_rss ( ) {
+
+  struct rusage usage;
+  if (getrusage (RUSAGE_SELF, &usage)) return 0;
+  return (size_t) usage.ru_maxrss * 1024;                  // kilobytes on Linux
+}
+
+/*-------------------------------------------------------------------------+
+ | Quote 'text' as a JSON string.                                          |
+/*-------------------------------------------------------------------------*/
+static std::string quote (const std::string& text) {
+
+  std::string quoted = "\"";
+  for (const char ch : text) {
+    if (ch == '"' || ch == '\\') quoted += '\\', quoted += ch;
+    else if ((unsigned char) ch < 0x20) {
+      char escaped[8];
+      snprintf (escaped, sizeof escaped, "\\u%04x", ch);
+      quoted += escaped;
+    } else quoted += ch;
+  }
+  return quoted + "\"";
+}
+
+/*-------------------------------------------------------------------------+
+ | Quote 'text' as a CSV field.                                            |
+/*-------------------------------------------------------------------------*/
+static std::string quote_csv (const std::string& text) {
+
+  std::string quoted = "\"";
+  for (const char ch : text) {
+    if (ch == '"') quoted += '"';
+    quoted += ch;
+  }
+  return quoted + "\"";
+}
+
+/*-------------------------------------------------------------------------+
+ | Named hardware events of 'counts'.                                      |
+/*-------------------------------------------------------------------------*/
+static std::vector<std::pair<const char*, long>> events (const Hardware& counts) {
+
+  return { { "cycles", counts.cycles },
+           { "instructions", counts.instructions },
+           { "cache_misses", counts.cache_misses },
+           { "branch_misses", counts.branch_misses } };
+}
+
+/*-------------------------------------------------------------------------+
+ | Write the record of 'instance' solved/simplified by 'cdcl' with result  |
+ | 'status' in 'total' seconds.                                            |
+/*-------------------------------------------------------------------------*/
+void Report::write (const std::string& instance, const CDCL& cdcl, const int status, const double total) {
+
+  const Stats& stats = cdcl.stats;
+  const size_t rss = peak_rss ( );
+
+/* One JSON object per line */
+  if (format == json) {
+    out << "{\"instance\":" << quote (instance) << ",\"status\":" << status
+        << ",\"vars\":" << cdcl.param.vars << ",\"clauses\":" << cdcl.param.n_cls_start
+        << ",\"time\":{\"total\":" << total;
+    for (const auto& time : stats.times ( ))
+      out << ",\"" << time.first << "\":" << time.second;
+    out << "},\"bytes\":{\"peak_rss\":" << rss;
+    for (const auto& bytes : stats.bytes ( ))
+      out << ",\"" << bytes.first << "\":" << bytes.second;
+    out << "},\"stats\":{";
+    const char* separator = "";
+    for (const auto& counter : stats.counters ( )) {
+      out << separator << "\"" << counter.first << "\":" << counter.second;
+      separator = ",";
+    }
+    out << "}";
+
+  /* Hardware events of the phases in which they were sampled */
+    bool any = false;
+    for (int p = 0; p < Stats::phases; ++p) {
+      if (stats.hardware[p].cycles < 0 && stats.hardware[p].instructions < 0) continue;
+      out << (any ? "," : ",\"perf\":{") << "\"" << Stats::phase_name (p) << "\":{";
+      any = true;
+      separator = "";
+      for (const auto& event : events (stats.hardware[p])) {
+        out << separator << "\"" << event.first << "\":" << event.second;
+        separator = ",";
+      }
+      out << "}";
+    }
+    if (any) out << "}";
+    out << "}" << std::endl;
+    return;
+  }
+
+/* CSV with header line */
+  if (!header) {
+    out << "instance,status,vars,clauses,time_total";
+    for (const auto& time : stats.times ( )) out << ",time_" << time.first;
+    out << ",bytes_peak_rss";
+    for (const auto& bytes : stats.bytes ( )) out << ",bytes_" << bytes.first;
+    for (const auto& counter : stats.counters ( )) out << "," << counter.first;
+    for (int p = 0; p < Stats::phases; ++p)
+      for (const auto& event : events (stats.hardware[p]))
+        out << ",perf_" << Stats::phase_name (p) << "_" << event.first;
+    out << std::endl;
+    header = true;
+  }
+  out << quote_csv (instance) << "," << status << "," << cdcl.param.vars << "," << cdcl.param.n_cls_start << "," << total;
+  for (const auto& time : stats.times ( )) out << "," << time.second;
+  out << "," << rss;
+  for (const auto& bytes : stats.bytes ( )) out << "," << bytes.second;
+  for (const auto& counter : stats.counters ( )) out << "," << counter.second;
+  for (int p = 0; p < Stats::phases; ++p)
+    for (const auto& event : events (stats.hardware[p]))
+      out << "," << event.second;
+  out << std::endl;
+}
+
+} //End namespace sat
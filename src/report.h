@@ -0,0 +1,66 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+
+/*-------- General includes ----------------------------------------*/
+#include <ostream>
+#include <string>
+
+/*-------- Header Includes --------------------------------------*/
+#include "solver.h"
+
+#ifndef REPORT_H
+#define REPORT_H
+
+namespace sat {
+
+/*-------------------------------------------------------------------------+
+ | Per-instance performance report. Each call of 'write' emits one record  |
+ | with the status, the size of the instance, the total time and the phase |
+ | times of 'Stats' (parse, signature, occurrence lists and each           |
+ | technique), the peak resident set size of the process and the bytes held|
+ | by the clause store, the occurrence lists and the mark arrays (see      |
+ | 'CDCL::measure_memory'), all 'Stats' counters and, with 'modes.perf',   |
+ | the hardware events of each phase (see 'perf.h'). Records are written as|
+ | JSON lines or as CSV with a header line before the first record.        |
+/*-------------------------------------------------------------------------*/
+class Report {
+
+  public:
+
+    enum Format { json, csv };
+
+    Report (std::ostream& out_, const Format format_) : out {out_}, format {format_} { }
+    ~Report ( ) { }
+
+    void write (const std::string& instance, const CDCL& cdcl, const int status, const double total);
+    static size_t peak_rss ( );
+
+  private:
+
+    std::ostream& out;                       // output stream
+    Format format;                           // JSON lines or CSV
+    bool header = false;                     // CSV header written
+};
+
+} //End namespace sat
+
+#endif
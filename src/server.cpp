@@ -0,0 +1,317 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "server.h"
+
+namespace sat {
+
+/*-------------------------------------------------------------------------+
+ | Read the next line (without '\n') from 'fd' into 'line'. Bytes read     |
+ | beyond the line are kept in 'buffer'. Returns false at end of input.    |
+/*-------------------------------------------------------------------------*/
+static bool read_line (const int fd, std::string& buffer, std::string& line) {
+
+  size_t pos;
+  while ((pos = buffer.find ('\n')) == std::string::npos) {
+    char chunk[4096];
+    const ssize_t n = recv (fd, chunk, sizeof chunk, 0);
+    if (n <= 0) {
+      if (buffer.empty ( )) return false;
+      pos = buffer.size ( );
+      buffer.push_back ('\n');
+      break;
+    }
+    buffer.append (chunk, n);
+  }
+  line.assign (buffer, 0, pos);
+  buffer.erase (0, pos + 1);
+  return true;
+}
+
+/*-------------------------------------------------------------------------+
+ | Make sure that 'buffer' holds at least 'size' bytes read from 'fd'.     |
+/*-------------------------------------------------------------------------*/
+static bool read_bytes (const int fd, std::string& buffer, const size_t size) {
+
+  buffer.reserve (size);
+  while (buffer.size ( ) < size) {
+    char chunk[1 << 16];
+    const ssize_t n = recv (fd, chunk, std::min (sizeof chunk, size - buffer.size ( )), 0);
+    if (n <= 0) return false;
+    buffer.append (chunk, n);
+  }
+  return true;
+}
+
+/*-------------------------------------------------------------------------+
+ | Write all of 'data' to 'fd'.                                            |
+/*-------------------------------------------------------------------------*/
+static bool write_all (const int fd, const std::string& data) {
+
+  for (size_t done = 0; done < data.size ( ); ) {
+    const ssize_t n = send (fd, data.data ( ) + done, data.size ( ) - done, MSG_NOSIGNAL);
+    if (n <= 0) return false;
+    done += n;
+  }
+  return true;
+}
+
+/*-------------------------------------------------------------------------+
+ | Open a Unix domain socket address for 'path'.                           |
+/*-------------------------------------------------------------------------*/
+static bool socket_address (const std::string& path, sockaddr_un& addr) {
+
+  if (path.size ( ) >= sizeof addr.sun_path) {
+    std::cout << "WARNING: socket path '" << path << "' is too long" << std::endl;
+    return false;
+  }
+  memset (&addr, 0, sizeof addr);
+  addr.sun_family = AF_UNIX;
+  strcpy (addr.sun_path, path.c_str ( ));
+  return true;
+}
+
+/*-------------------------------------------------------------------------+
+ | Listen on the socket and hand out connections to the workers until a    |
+ | 'shutdown' request arrives. Queued connections are still served.        |
+/*-------------------------------------------------------------------------*/
+int Server::run ( ) {
+
+  sockaddr_un addr;
+  if (!socket_address (path, addr)) return 1;
+  listener = socket (AF_UNIX, SOCK_STREAM, 0);
+  unlink (path.c_str ( ));
+  if (listener < 0 || bind (listener, (sockaddr*) &addr, sizeof addr) || listen (listener, 64)) {
+    std::cout << "WARNING: could not listen on '" << path << "': " << strerror (errno) << std::endl;
+    if (listener >= 0) close (listener);
+    return 1;
+  }
+  std::cout << "[SERVER] listening on '" << path << "' with " << workers << " workers" << std::endl;
+
+/* Start workers with one warm solver each */
+  std::vector<std::thread> pool;
+  for (int i = 0; i < workers; ++i)
+    pool.emplace_back (&Server::work, this);
+
+/* Accept connections */
+  for (;;) {
+    const int fd = accept (listener, 0, 0);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      break;                                     // closed by 'stop'
+    }
+    std::lock_guard<std::mutex> lock (mutex);
+    if (stopping) { close (fd); break; }
+    connections.push_back (fd);
+    ready.notify_one ( );
+  }
+  stop ( );
+  for (std::thread& worker : pool) worker.join ( );
+  close (listener);
+  unlink (path.c_str ( ));
+  return 0;
+}
+
+/*-------------------------------------------------------------------------+
+ | Stop accepting connections and let the workers finish.                  |
+/*-------------------------------------------------------------------------*/
+void Server::stop ( ) {
+
+  {
+    std::lock_guard<std::mutex> lock (mutex);
+    stopping = true;
+  }
+  ready.notify_all ( );
+  shutdown (listener, SHUT_RDWR);                // wakes up 'accept'
+}
+
+/*-------------------------------------------------------------------------+
+ | Worker loop. The solver is reset between jobs, which keeps its buffers. |
+/*-------------------------------------------------------------------------*/
+void Server::work ( ) {
+
+  CDCL cdcl;
+  for (;;) {
+    int fd;
+    {
+      std::unique_lock<std::mutex> lock (mutex);
+      ready.wait (lock, [this] ( ) { return stopping || !connections.empty ( ); });
+      if (connections.empty ( )) return;
+      fd = connections.front ( );
+      connections.pop_front ( );
+    }
+    serve (fd, cdcl);
+    close (fd);
+  }
+}
+
+/*-------------------------------------------------------------------------+
+ | Serve all requests of one connection.                                   |
+/*-------------------------------------------------------------------------*/
+void Server::serve (const int fd, CDCL& cdcl) {
+
+  std::string buffer, request;
+  while (read_line (fd, buffer, request))
+    if (!request.empty ( ) && !job (fd, cdcl, request, buffer))
+      break;
+}
+
+/*-------------------------------------------------------------------------+
+ | Run the job 'request' and send back its results. Returns false if the   |
+ | connection should be closed.                                            |
+/*-------------------------------------------------------------------------*/
+bool Server::job (const int fd, CDCL& cdcl, const std::string& request, std::string& buffer) {
+
+  TraceScope trace ("job");
+  std::istringstream stream (request);
+  std::vector<std::string> tokens;
+  for (std::string token; stream >> token; ) tokens.push_back (token);
+  if (tokens.empty ( )) return true;
+
+  if (tokens[0] == "shutdown") {
+    write_all (fd, "ok\nend\n");
+    stop ( );
+    return false;
+  }
+  if ((tokens[0] != "file" && tokens[0] != "cnf") || tokens.size ( ) < 2)
+    return write_all (fd, "error unknown request '" + request + "'\nend\n");
+
+/* Read flags */
+  Modes modes;
+  modes.block = false;
+  bool output = false;
+  for (size_t i = 2; i < tokens.size ( ); ++i) {
+    if      (tokens[i] == "subsume") modes.subsume = true;
+    else if (tokens[i] == "block")   modes.block   = true;
+    else if (tokens[i] == "elim")    modes.elim    = true;
+    else if (tokens[i] == "hash")    modes.hash    = true;
+    else if (tokens[i] == "adaptive") modes.adaptive = true;
+    else if (tokens[i] == "substitute") modes.substitute = true;
+    else if (tokens[i] == "cover")   modes.cover   = true;
+    else if (tokens[i] == "output")  output        = true;
+    else return write_all (fd, "error unknown flag '" + tokens[i] + "'\nend\n");
+  }
+
+/* Read formula */
+  auto start = std::chrono::high_resolution_clock::now ( );
+  std::string file;
+  size_t size;
+  if (tokens[0] == "file") {
+    if (!CDCL::read_file (tokens[1], file)) return write_all (fd, "error could not read '" + tokens[1] + "'\nend\n");
+    size = file.size ( );
+  }
+  else {
+
+  /* Sizes which are no number or too large end the connection, since the
+     bytes of the formula cannot be skipped */
+    char* last;
+    size = std::strtoull (tokens[1].c_str ( ), &last, 10);
+    if (*last || tokens[1][0] == '-' || size > max_cnf_bytes) {
+      write_all (fd, "error invalid size '" + tokens[1] + "'\nend\n");
+      return false;
+    }
+    if (!read_bytes (fd, buffer, size)) return false;
+    file.assign (buffer, 0, size);
+    buffer.erase (0, size);
+  }
+  const char* begin = file.data ( );
+  const char* end_ = begin + size;
+
+/* Look up the result cache */
+  cdcl.reset ( );
+  const uint64_t key = cache.enabled ( ) ? Cache::key (begin, end_, modes, cdcl.lims) : 0;
+  int status;
+  const bool hit = cache.enabled ( ) && cache.load (key, cdcl, status);
+  auto parsed = std::chrono::high_resolution_clock::now ( );
+  if (!hit) {
+    if (!cdcl.parse_dimacs (begin, end_)) {
+      cdcl.reset ( );
+      return write_all (fd, "error could not read formula\nend\n");
+    }
+    parsed = std::chrono::high_resolution_clock::now ( );
+
+  /* Simplify */
+    status = cdcl.simplify (modes);
+    if (cache.enabled ( ) && !cdcl.stats.timeouts) cache.store (key, cdcl, status);
+  }
+  auto end = std::chrono::high_resolution_clock::now ( );
+
+/* Send statistics and (optionally) the simplified formula */
+  std::string answer = "s " + std::to_string (status) + "\n";
+  if (cache.enabled ( )) answer += hit ? "cache hit\n" : "cache miss\n";
+  for (const auto& counter : cdcl.stats.counters ( ))
+    answer += "stat " + std::string (counter.first) + " " + std::to_string (counter.second) + "\n";
+  answer += "time parse " + std::to_string (std::chrono::duration<double>(parsed - start).count ( )) + "\n";
+  answer += "time simplify " + std::to_string (std::chrono::duration<double>(end - parsed).count ( )) + "\n";
+
+/* An inconsistent formula is sent as the empty clause alone, since the
+   empty clause is not kept in the clause list */
+  if (output && status == 20)
+    answer += "p cnf " + std::to_string (cdcl.param.vars) + " 1\n0\n";
+  else if (output) {
+    size_t clauses = cdcl.units ( ).size ( );
+    for (auto it = cdcl.clauses ( ).begin ( ); it != cdcl.clauses ( ).end ( ); ++it) ++clauses;
+    answer += "p cnf " + std::to_string (cdcl.param.vars) + " " + std::to_string (clauses) + "\n";
+    for (const int lit : cdcl.units ( ))
+      answer += std::to_string (lit) + " 0\n";
+    for (const Clause& c : cdcl.clauses ( )) {
+      for (const int lit : c) answer += std::to_string (lit) + " ";
+      answer += "0\n";
+    }
+  }
+  answer += "end\n";
+  cdcl.reset ( );
+  return write_all (fd, answer);
+}
+
+/*-------------------------------------------------------------------------+
+ | Client side of the protocol (see 'server.h').                           |
+/*-------------------------------------------------------------------------*/
+int submit (const std::string& path, const std::string& request, const std::string& payload) {
+
+  sockaddr_un addr;
+  if (!socket_address (path, addr)) return 1;
+  const int fd = socket (AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0 || connect (fd, (sockaddr*) &addr, sizeof addr)) {
+    std::cout << "WARNING: could not connect to '" << path << "': " << strerror (errno) << std::endl;
+    if (fd >= 0) close (fd);
+    return 1;
+  }
+  if (!write_all (fd, request + "\n" + payload)) { close (fd); return 1; }
+  shutdown (fd, SHUT_WR);
+
+/* Copy the answer */
+  int res = 0;
+  std::string buffer, line;
+  while (read_line (fd, buffer, line)) {
+    if (!line.compare (0, 5, "error")) res = 1;
+    std::cout << line << "\n";
+  }
+  std::cout << std::flush;
+  close (fd);
+  return res;
+}
+
+} //End namespace sat
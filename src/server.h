@@ -0,0 +1,94 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+
+/*-------- General includes ----------------------------------------*/
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/*-------- Header Includes --------------------------------------*/
+#include "cache.h"
+#include "solver.h"
+
+#ifndef SERVER_H
+#define SERVER_H
+
+namespace sat {
+
+/*-------------------------------------------------------------------------+
+ | Preprocessing service on a Unix domain socket. Connections are served   |
+ | by a pool of worker threads, each of which keeps one warm 'CDCL' object |
+ | for all of its jobs. A connection sends one or more requests            |
+ |                                                                         |
+ |   file <path> [flags]          (DIMACS file readable by the server)     |
+ |   cnf <bytes> [flags]          (followed by <bytes> bytes of DIMACS)    |
+ |   shutdown                     (stop the server)                        |
+ |                                                                         |
+ | where flags are 'substitute', 'subsume', 'block', 'cover', 'elim',      |
+ | 'hash', 'adaptive' (see 'Modes') and 'output'. Each request is answered |
+ | by 's <status>', 'stat <name> <val>' and 'time <name> <seconds>' lines, |
+ | followed by the simplified formula in DIMACS if 'output' was given (the |
+ | empty clause alone for status 20), and finally a line 'end'. Errors are |
+ | reported as 'error <message>' followed by 'end'. With a result cache    |
+ | (see 'cache.h') the answer also holds a line 'cache <hit|miss>'. Inline |
+ | formulas are limited to 'max_cnf_bytes' bytes; a larger size is answered|
+ | by an error and closes the connection.                                  |
+/*-------------------------------------------------------------------------*/
+class Server {
+
+  public:
+
+    Server (const std::string& path_, const int workers_, const Cache& cache_ = Cache ( )) :
+      path {path_}, workers {workers_}, cache {cache_} { }
+    ~Server ( ) { }
+
+    int run ( );
+
+  private:
+
+    void work ( );
+    void serve (const int fd, CDCL& cdcl);
+    bool job (const int fd, CDCL& cdcl, const std::string& request, std::string& buffer);
+    void stop ( );
+
+    static const size_t max_cnf_bytes = 1ULL << 30; // size limit of 'cnf' requests
+    std::string path;                        // socket path
+    int workers;                             // number of worker threads
+    Cache cache;                             // result cache (optional)
+    int listener = -1;                       // listening socket
+    bool stopping = false;                   // set by 'shutdown'
+    std::mutex mutex;                        // protects 'connections' and 'stopping'
+    std::condition_variable ready;           // signals new connections
+    std::deque<int> connections;             // accepted connections to serve
+};
+
+/*-------------------------------------------------------------------------+
+ | Client side: send 'request' (with optional DIMACS 'payload' for 'cnf'   |
+ | requests) to the server at 'path' and copy the answer to std::cout.     |
+/*-------------------------------------------------------------------------*/
+int submit (const std::string& path, const std::string& request, const std::string& payload);
+
+} //End namespace sat
+
+#endif
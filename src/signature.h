@@ -0,0 +1,72 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+/*-------- General includes ----------------------------------------*/
+#include <cstdint>
+
+/*-------- Header Includes --------------------------------------*/
+#include "clause.h"
+
+#ifndef SIGNATURE_H
+#define SIGNATURE_H
+
+namespace sat {
+
+/*-------------------------------------------------------------------------+
+ | Occurrence of a clause together with its signature (see 'compute_hash') |
+ | and its first two literals (those of its smallest variables). The marks |
+ | of these literals reject candidates of subsumption and certify          |
+ | tautological resolvents in BCE and BVE without loading the clause (see  |
+ | 'occurrence_clash'). The entry fills 32 bytes, so two of them share a   |
+ | cache line.                                                             |
+/*-------------------------------------------------------------------------*/
+struct OccrsHash {
+  OccrsHash (Clause* c_, uint64_t h, uint64_t u) : c {c_}, hash {h}, unique {u}, lits {c_->lits[0], c_->lits[1]} { }
+  Clause* c        =    0;        // clause pointer
+  uint64_t hash    = 0ULL;        // hash value
+  uint64_t unique  = 0ULL;        // uniqueness of 'hash'
+  int lits[2];                    // first two literals of 'c'
+};
+
+/*-------------------------------------------------------------------------+
+ | Signature filters of subsumption, BCE and BVE. A signature has the bit  |
+ | 'abs (lit) % 64' set for each literal of a clause and 'unique' the bits |
+ | set by more than one literal. The filters never reject a pair which the |
+ | literal check would accept, so they only decide when the (expensive)    |
+ | check of the literals can be skipped.                                   |
+/*-------------------------------------------------------------------------*/
+
+/* Can 'd' subsume or strengthen 'c'? Expects 'nhash = ~c->hash' and
+   'nunique = ~c->unique'. False if 'd' has a variable not in 'c'. */
+inline bool subsume_candidate (const OccrsHash& d, const uint64_t nhash, const uint64_t nunique) {
+  return !((d.hash & nhash) | (d.unique & nunique));
+}
+
+/* Is the resolvent of 'c' and 'd' on the variable with bit 'idx' surely
+   not tautological? Expects 'hci = c->hash & ~idx' and 'uci = c->unique
+   & idx'. True if 'c' and 'd' share no other variable. */
+inline bool resolvent_disjoint (const uint64_t hci, const uint64_t uci, const OccrsHash& d) {
+  return !((hci & d.hash) | (uci & d.unique));
+}
+
+} //End namespace sat
+
+#endif
@@ -29,9 +29,18 @@ namespace sat {
 /*-------------------------------------------------------------------------*/
 int CDCL::solve (const std::string dimacs, const std::vector<int>& asmt) {
 
+  TraceScope trace ("solve");
+
 /* read cnf dimacs */
+  init_statistics ( );
+  budget.expire (modes.timeout);
+  adapt_subsume = adapt_block = Adaptive ( );
+  if (modes.adaptive) modes.hash = true;       // lists with signatures
   if (!read_dimacs (dimacs)) return exit_with (-1);
 
+/* Assumptions are excluded from BCE/BVE */
+  for (const int lit : asmt) freeze (lit);
+
 /* Initialize model stack and watched literal list */
   init_solver ( );
 
@@ -42,27 +51,190 @@ int CDCL::solve (const std::string dimacs, const std::vector<int>& asmt) {
   stats.preprocess_end = std::chrono::high_resolution_clock::now ( );
 
 /* Exit */
+  measure_memory ( );
   return exit_with (0);
 }
 
+/*-------------------------------------------------------------------------+
+ | Simplify the clauses added through 'add_clause'/'add_clauses' (or read  |
+ | by 'read_dimacs') with every technique enabled in 'modes_'. Unlike      |
+ | 'solve', the techniques actually remove and strengthen clauses and the  |
+ | formula stays alive, so the surviving clauses can be accessed through   |
+ | 'clauses' and 'units' and more clauses can be added for the next call.  |
+ | Variables of assumptions (see 'assume') are not removed during the      |
+ | call. With 'modes_.incremental' the occurrence index is kept alive      |
+ | between calls (see 'incremental.cpp'). Returns 20 if the formula is     |
+ | inconsistent.                                                           |
+/*-------------------------------------------------------------------------*/
+int CDCL::simplify (const Modes& modes_) {
+
+  TraceScope trace ("simplify");
+  modes = modes_;
+  modes.apply = true;
+  if (state.inconsistent) return 20;
+  budget.expire (modes.timeout);
+  if (modes.adaptive) modes.hash = true;       // lists with signatures
+
+/* Initialize statistics (keeping the input phases of 'parse_dimacs'),
+   parameters and variable containers */
+  const Stats input = stats;
+  init_statistics ( );
+  for (const Stats::Phase p : { Stats::parse, Stats::signature })
+    stats.time[p] = input.time[p], stats.hardware[p] = input.hardware[p];
+  init_parameters ( );
+  enlarge (param.vars);
+
+/* Restore removed clauses invalidated by new clauses and freeze assumptions */
+  restore ( );
+  for (const int lit : assumptions) freeze (lit);
+
+/* Substitution / subsumption / BCE / BVE calls */
+  if (modes.substitute) substitute_call ( );
+  if (modes.incremental) simplify_incremental ( );
+  else {
+    if (occurring ( )) reset_occrs ( );
+    init_model ( );
+    init_block ( );
+    if (modes.subsume) { subsume_forward ( ); reset_occrs ( ); }
+    if (modes.block)   { block_call ( );      reset_occrs ( ); }
+    if (modes.elim)    { elim_call ( );       reset_occrs ( ); }
+  }
+  stats.preprocess_end = std::chrono::high_resolution_clock::now ( );
+
+/* Assumptions only hold for one call */
+  for (const int lit : assumptions) melt (lit);
+  assumptions.clear ( );
+
+/* Delete removed clauses. With a persistent index we only collect once
+   enough garbage accumulated, since this visits all clauses. */
+  if (!occurring ( )) collect_garbage ( );
+  else if (2*param.garbage > original.size ( )) {
+    flush_occrs ( );
+    collect_garbage ( );
+  }
+  param.original = original.size ( );
+  param.units = unit_clauses.size ( );
+  measure_memory ( );
+  return state.inconsistent ? 20 : 0;
+}
+
+/*-------------------------------------------------------------------------+
+ | Start the budget of the technique 'p' (subsume, block or elim). It gets |
+ | the smallest of its absolute budget, its share of the budget of the     |
+ | call ('lims.ticks') and what the earlier techniques left of the latter. |
+/*-------------------------------------------------------------------------*/
+void CDCL::budget_start (const Stats::Phase p) {
+
+  long ticks = 0, used = stats.subsume_ticks + stats.block_ticks + stats.elim_ticks;
+  double share = 1;
+  if      (p == Stats::subsume) ticks = lims.subsume_ticks, share = lims.subsume_share;
+  else if (p == Stats::block)   ticks = lims.block_ticks,   share = lims.block_share;
+  else if (p == Stats::elim)    ticks = lims.elim_ticks,    share = lims.elim_share;
+  long limit = ticks > 0 ? ticks : LONG_MAX;
+  if (lims.ticks > 0) {
+    limit = std::min (limit, (long) (share * lims.ticks));
+    limit = std::min (limit, std::max (0L, lims.ticks - used));
+  }
+  budget.start (limit);
+}
+
+/*-------------------------------------------------------------------------+
+ | Add the effort of the technique 'p' to the statistics.                  |
+/*-------------------------------------------------------------------------*/
+void CDCL::budget_stop (const Stats::Phase p) {
+
+  if      (p == Stats::subsume) stats.subsume_ticks += budget.ticks;
+  else if (p == Stats::block)   stats.block_ticks   += budget.ticks;
+  else if (p == Stats::elim)    stats.elim_ticks    += budget.ticks;
+  if (budget.timeout) ++stats.timeouts;
+  else if (budget.stopped) ++stats.stopped;
+}
+
 /*-------------------------------------------------------------------------+
  | This is called upon confirming satisfiability/unsatisfiability of the   |
  | problem.                                                                |
 /*-------------------------------------------------------------------------*/
 int CDCL::exit_with (const int code) {
 
+  clear_formula ( );
+  return 0;
+}
+
+/*-------------------------------------------------------------------------+
+ | Prepare the solver for a new formula (read with 'read_dimacs' or added  |
+ | with 'add_clause'). All containers keep their capacity, so a reused     |
+ | solver only allocates when a larger instance arrives.                   |
+/*-------------------------------------------------------------------------*/
+void CDCL::reset ( ) {
+
+  clear_formula ( );
+  const int vars_alloc = param.vars_alloc;
+  param = Params ( );
+  param.vars_alloc = vars_alloc;
+  state = State ( );
+  stats = Stats ( );
+  adapt_subsume = adapt_block = Adaptive ( );
+}
+
+/*-------------------------------------------------------------------------+
+ | Delete all clauses and empty the containers of the formula without      |
+ | releasing their memory. Parameters and statistics are kept, so that     |
+ | they can still be read after 'solve'.                                   |
+/*-------------------------------------------------------------------------*/
+void CDCL::clear_formula ( ) {
+
 /* Delete allocated clauses */
   while (!original.empty ( )) {
     delete_clause (original.back ( ));
     original.pop_back ( );
   }
-  model -= param.vars;
-  delete [] model;
-  bmark -= param.vars;
-  delete [] bmark;
-  if (modes.elim || modes.block)
+  reset_occrs ( );
+  param.original = param.units = param.garbage = 0;
+  state.inconsistent = false;
+  unit_clauses.clear ( );
+  extension.clear ( );
+  candsizes.clear ( );
+  assumptions.clear ( );
+  std::fill (frozentab.begin ( ), frozentab.end ( ), 0);
+  std::fill (witnesses.begin ( ), witnesses.end ( ), 0);
+}
+
+/*-------------------------------------------------------------------------+
+ | Delete all clauses and release the memory of all containers.            |
+/*-------------------------------------------------------------------------*/
+void CDCL::release ( ) {
+
+  clear_formula ( );
+  if (model) {
+    model -= param.vars_alloc;
+    delete [] model;
+    bmark -= param.vars_alloc;
+    delete [] bmark;
     delete [] block;
-  return 0;
+    model = 0, bmark = 0, block = 0;
+  }
+  param.vars_alloc = 0;
+  std::vector<std::vector<Clause*>> ( ).swap (occrs);
+  std::vector<std::vector<OccrsHash>> ( ).swap (occrshash);
+  std::vector<std::vector<std::pair<uint64_t, uint64_t>>> ( ).swap (ohu);
+  frozentab.clear ( );
+  witnesses.clear ( );
+  dirty.clear ( );
+}
+
+/*-------------------------------------------------------------------------+
+ | Delete clauses removed during simplification. Must only be called when  |
+ | no occurrence list refers to the clauses anymore.                       |
+/*-------------------------------------------------------------------------*/
+void CDCL::collect_garbage ( ) {
+
+  size_t j = 0;
+  for (Clause* c : original) {
+    if (c->garbage) delete_clause (c);
+    else original[j++] = c;
+  }
+  original.resize (j);
+  param.garbage = 0;
 }
 
 /*-------------------------------------------------------------------------+
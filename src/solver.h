@@ -36,12 +36,18 @@
 #include <climits>
 
 /*-------- Header Includes --------------------------------------*/
+#include "adaptive.h"
+#include "budget.h"
 #include "clause.h"
+#include "kernels.h"
 #include "limits.h"
 #include "modes.h"
 #include "params.h"
+#include "perf.h"
+#include "signature.h"
 #include "stats.h"
 #include "state.h"
+#include "trace.h"
 #include "util.h"
 #include "watcher.h"
 
@@ -50,24 +56,12 @@
 
 namespace sat {
 
-struct Sort_cls_size_subsume : std::binary_function <std::pair<Clause*,size_t>,std::pair<Clause*,size_t>,bool> {
-  Sort_cls_size_subsume ( ) { }
-  bool operator ( ) (std::pair<Clause*,size_t>& x, std::pair<Clause*,size_t>& y ) { return x.second < y.second; }
-};
-
 class CDCL {
 
-  struct OccrsHash {
-    OccrsHash (Clause* c_, uint64_t h, uint64_t u) : c {c_}, hash {h}, unique {u} { }
-    Clause* c        =    0;        // clause pointer
-    uint64_t hash    = 0ULL;        // hash value
-    uint64_t unique  = 0ULL;        // uniqueness of 'hash'
-  };
-
   public:
 
     CDCL ( ) { };
-    ~CDCL ( ) { };
+    ~CDCL ( ) { release ( ); };
 
 /*-------------------------------------------------------------------------+
  | Map a positive/negative literals to positive indices in [0,2*nvars + 1].|
@@ -118,11 +112,24 @@ class CDCL {
     void block_init_occrs ( );
     void block_literal (const int lit);
     bool block_check (const Clause* c, const int block);
-    bool block_check_hash (const OccrsHash& chu, const int block, const uint64_t idx);
+    bool block_check_hash (const OccrsHash& chu, const int block, const uint64_t idx, Count& matches);
+    void block_remove (Clause* c, const int bvar);
+    void block_cover_clauses (const int lit);
+    bool block_cover (Clause* c);
+    bool block_cover_common (const int lit, const uint64_t hash, const uint64_t unique, long& ticks,
+                             Count& matches);
+
+  /* cache.cpp */
+    void write_binary (std::string& out, const int status) const;
+    bool read_binary (const std::string& in, int& status);
 
   /* clause.cpp */
-    Clause* new_clause (const std::vector<int>& lits);
+    Clause* new_clause (const std::vector<int>& lits, const bool hash = true);
     void compute_hash (Clause* c);
+    void sort_lits (Clause* c);
+    void mark_garbage (Clause* c);
+    void push_extension (const Clause* c, const int witness);
+    void push_extension (const int* lits, const size_t size, const int witness);
 
   /* elim.cpp */
     void elim_call ( );
@@ -132,6 +139,26 @@ class CDCL {
     bool elim_check_hash (const uint64_t ch, const uint64_t cu, const uint64_t dh, const uint64_t du, const uint64_t idx);
     bool elim_resolvents_bounded (const int lit);
     bool elim_resolvents_bounded_signature (const int lit);
+    bool elim_resolvents_bounded_gate (const int evar);
+    bool elim_find_gate (const int evar);
+    bool elim_find_and (const int lit);
+    bool elim_find_ite (const int evar);
+    bool elim_find_xor (const int evar);
+    void elim_flag_gate (Clause* c);
+    void elim_eliminate (const int evar);
+    void elim_collect (const int evar);
+    void elim_add_resolvent (const std::vector<int>& lits);
+
+  /* incremental.cpp */
+    void freeze (const int lit);
+    void melt (const int lit);
+    bool frozen (const int lit) const { return frozentab[abs (lit)] > 0; }
+    void assume (const int lit);
+    void mark_dirty (const int lit);
+    void simplify_incremental ( );
+    void incremental_index ( );
+    void restore ( );
+    void restore_clauses (const std::vector<int>& seeds);
 
   /* init.cpp */
     void init_solver ( );
@@ -145,31 +172,73 @@ class CDCL {
     void set_modes (Modes& modes_) { modes = modes_; }
   
   /* input.cpp */
+    static bool read_file (const std::string& file_name, std::string& buffer);
     bool read_dimacs (const std::string file_name);
+    bool parse_dimacs (const char* begin, const char* end);
+    static void tokenize (const char* begin, const char* end, std::vector<int>& numbers);
     bool tautology (std::vector<int>& lits);
+    void add_clause (const int* lits, const size_t size);
+    void add_clause (const std::vector<int>& lits) { add_clause (lits.data ( ), lits.size ( )); }
+    void add_clauses (const int* lits, const size_t size);
+    void enlarge (const int vars);
+
+  /* perf.cpp */
+    Timer phase (const Stats::Phase p) { return Timer (stats, p, modes.perf ? &perf : 0); }
+
+  /* report.cpp */
+    void measure_memory ( );
 
   /* solver.cpp */
     int solve (const std::string dimacs, const std::vector<int>& asmt);
+    int simplify (const Modes& modes_);
+    void budget_start (const Stats::Phase p);
+    void budget_stop (const Stats::Phase p);
     int exit_with (const int code);
+    void reset ( );
+    void clear_formula ( );
+    void release ( );
+    void collect_garbage ( );
     void delete_clause (Clause* c);
+    Clauses clauses ( ) const { return Clauses (original.data ( ), original.data ( ) + original.size ( )); }
+    const std::vector<int>& units ( ) const { return unit_clauses; }
+    const std::vector<int>& removed ( ) const { return extension; }
+
+  /* substitute.cpp */
+    void substitute_call ( );
+    bool substitute_find ( );
+    void substitute_clause (Clause* c);
+    int substitute (const int lit) { return frozen (lit) ? lit : reprs[widx (lit)]; }
 
   /* subsume.cpp */
-    bool simplify ( );
     void subsumption ( );
     bool subsume_forward ( );
     void subsume_candidates ( );
+    void subsume_schedule ( );
     void subsume_find_candidates (std::vector<Clause*>& clauses);
     void subsume_check (Clause* c);
     void subsume_check_hash (Clause* c);
+    int subsume_occs_hash (const int lit, const int size, const uint64_t nhash, const uint64_t nunique,
+                           Count& checks, Count& matches);
     int subsumed (const Clause* c);
+    int subsumed_merge (const Clause* c, const Clause* d);
+    int subsume_merge_size ( );
+    int subsume_sign (const int lit);
     int subsume_min_occrs (const Clause* c);
     int subsume_min_occrs_hash (const Clause* c);
+    void subsume_apply (Clause* c, const int str);
+    void subsume_incremental ( );
+    int subsume_backward (const Clause* c);
 
   /* watcher.cpp */
     bool occurring ( ) { return state.occurring; }
     void init_occrs ( );
     void init_occrs_hash ( );
     void init_ohu ( );
+    void reset_occrs ( );
+    void flush_occrs ( );
+    void flush_occrs (const int lit);
+    void add_occrs (Clause* c, const int max_size);
+    bool occurrence_clash (const OccrsHash& d, const int lit);
 
 /* ------------------------------------------------------------------------ */
     Params param;                            // solver variables
@@ -177,19 +246,45 @@ class CDCL {
     Modes modes;                             // input modes
     Stats stats;                             // statistics
     State state;                             // current states
-    signed char* bmark;                      // marker container (see 'block.cpp/subsume.cpp')
-    signed char* block;                      // marker container (see 'block.cpp')
+    Perf perf;                               // hardware counters (see 'modes.perf')
+    Budget budget;                           // effort of the running technique
+    Adaptive adapt_subsume;                  // signature filter or marking (see 'modes.adaptive')
+    Adaptive adapt_block;                    // dito for BCE
+    signed char* bmark = 0;                  // marker container (see 'block.cpp/subsume.cpp')
+    signed char* block = 0;                  // marker container (see 'block.cpp')
     std::vector<std::pair<Clause*,size_t>> candsizes;              // container for candidate clauses (see 'subsume.cpp')
+    std::vector<std::pair<Clause*,size_t>> candbuckets;            // candidates distributed by size (see 'subsume_schedule')
+    std::vector<size_t> candcounts;          // first bucket position per size (dito)
+    const Clause* merging = 0;               // long clause checked by merging (see 'subsumed')
 
   private:
 
     std::vector<OccrsHash>& occhash (const int lit) { return occrshash[widx (lit)]; }
     std::vector<Clause*>& occurs (const int lit) { return occrs[widx (lit)]; }
+    template <class F> void each_clause (const int lit, F f) {    // clauses of 'lit' and their signatures
+      if (modes.hash) for (const OccrsHash& chu : occhash (lit)) f (chu.c, chu.hash);
+      else            for (Clause* c : occurs (lit)) f (c, c->hash);
+    }
     std::vector<std::pair<uint64_t, uint64_t>>& ochash (const int lit) { return ohu[widx (lit)]; }
     std::vector<int> unit_clauses;                 // see 'input.cpp' and 'preprocess.cpp'
     std::vector<std::vector<int>> clause_lits;     // clause buffer 'input.cpp'
     std::vector<Clause*> original;                 // original clauses
-    int* model;                                    // model
+    std::vector<int> extension;                    // removed clauses for model reconstruction
+    std::vector<int> add_lits;                     // clause buffer (see 'add_clause')
+    std::vector<int> dimacs_numbers;               // numbers of the DIMACS body (see 'parse_dimacs')
+    std::vector<int> assumptions;                  // assumptions of the next call (see 'incremental.cpp')
+    std::vector<int> frozentab;                    // freeze counters of variables
+    std::vector<signed char> witnesses;            // variables with witnesses on 'extension'
+    std::vector<signed char> dirty;                // variables scheduled for BCE/BVE (incremental)
+    std::vector<int> dirty_vars;                   // schedule of dirty variables
+    std::vector<int> reprs;                        // representatives of literals (see 'substitute.cpp')
+    std::vector<Clause*> gates;                    // clauses flagged as gate definition (see 'elim.cpp')
+    std::vector<Clause*> elim_pos, elim_neg;       // clauses of the eliminated variable (see 'elim.cpp')
+    std::vector<uint64_t> gate_hashes;             // signatures of candidate gate clauses (see 'elim.cpp')
+    std::vector<Clause*> gate_binaries;            // binary clauses of an AND gate candidate (see 'elim.cpp')
+    std::vector<int> covered, cover_common;        // extended clause and covered literals (see 'block_cover')
+    std::vector<std::pair<int,size_t>> cover_steps;  // witnesses and clause sizes of covered literal additions
+    int* model = 0;                                // model
     std::vector<std::vector<Clause*>> occrs;                    // occurrence list
     std::vector<std::vector<OccrsHash>> occrshash; // container for occurrences/hash pairs (see 'subsume.cpp')
     std::vector<std::vector<std::pair<uint64_t, uint64_t>>> ohu;
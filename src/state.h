@@ -30,6 +30,8 @@ struct State {
 
   ~State ( ) { }
   State ( ) { }
+  bool hash           =  false;
+  bool inconsistent   =  false;
   bool occurring      =  false;
 };
 
@@ -22,6 +22,43 @@
 #ifndef STATS_H
 #define STATS_H
 
+/* Count hot-path statistics (see 'Count'). Enabled by the CMake option
+   'SAT_PROFILE' for profiling builds. */
+#ifndef SAT_PROFILE
+#define SAT_PROFILE 0
+#endif
+
+/*-------------------------------------------------------------------------+
+ | Counter for hot loops. It lives in a register of the calling function   |
+ | and is added to a 'Stats' counter once per call with 'flush'. Without   |
+ | 'SAT_PROFILE' all operations are empty and the counter is compiled away |
+ | completely.                                                             |
+/*-------------------------------------------------------------------------*/
+template <bool enabled> struct Counter {
+  void operator++ ( ) { }
+  void operator+= (const long) { }
+  void flush (long&) { }
+};
+
+template <> struct Counter<true> {
+  void operator++ ( ) { ++n; }
+  void operator+= (const long x) { n += x; }
+  void flush (long& total) { total += n; n = 0; }
+  long n = 0;
+};
+
+typedef Counter<SAT_PROFILE> Count;
+
+/*-------------------------------------------------------------------------+
+ | Hardware event counts of a phase (see 'perf.h'), -1 if unavailable.     |
+/*-------------------------------------------------------------------------*/
+struct Hardware {
+  long cycles                              = -1; // CPU cycles
+  long instructions                        = -1; // retired instructions
+  long cache_misses                        = -1; // last level cache misses
+  long branch_misses                       = -1; // mispredicted branches
+};
+
 /*-------------------------------------------------------------------------+
  | Statistics container for class CDCL.                                    |
 /*-------------------------------------------------------------------------*/
@@ -30,22 +67,95 @@ struct Stats {
   ~Stats ( ) { }
   Stats ( ) { }
 
-  long block_checks                        = 0; // blocked clauses checked
+  long block_checks                        = 0; // blocked clauses checked (profiling)
   long block_clauses                       = 0; //
-  long block_hash_match                    = 0; // blocked clause checks mismatched by hash
+  long block_hash_match                    = 0; // blocked clause checks mismatched by hash (profiling)
+  long block_ticks                         = 0; // effort of BCE (see 'Budget')
+  long covered                             = 0; // clauses removed by CCE/ABCE (see 'block_cover')
   long elim_hashes                         = 0; // hash equivalences
   long eliminated                          = 0; //
-  long elim_hash_matches                   = 0; //
-  long elim_checks                         = 0; //
+  long elim_hash_matches                   = 0; // resolvents certified by signatures (profiling)
+  long elim_checks                         = 0; // resolvent pairs checked (profiling)
+  long elim_gates                          = 0; // gate definitions found in BVE
   long elim_resolvents                     = 0; //
+  long elim_ticks                          = 0; // effort of BVE (see 'Budget')
+  long restored                            = 0; // clauses restored from the extension stack
+  long stopped                             = 0; // techniques stopped by a tick budget
   long strengthened                        = 0; //
-  long subsume_checks                      = 0; // number of subsumption checks (i.e. calls to 'subsume_check')
-  long subsume_hash_matches                = 0; //
+  long substituted                         = 0; // variables replaced by equivalent literals
+  long subsume_checks                      = 0; // candidate clauses checked (profiling)
+  long subsume_hash_matches                = 0; // candidates rejected by signatures (profiling)
   long subsumed                            = 0; //
+  long subsume_ticks                       = 0; // effort of subsumption (see 'Budget')
+  long timeouts                            = 0; // techniques stopped by 'modes.timeout'
+  long unfiltered                          = 0; // occurrence lists checked without signatures (see 'Adaptive')
+
+/* Phases timed by 'Timer': reading DIMACS (see 'parse_dimacs'), clause
+   signatures, occurrence lists, equivalent literal substitution, subsump-
+   tion (with its watch lists), BCE and BVE (without occurrence lists) */
+  enum Phase { parse, signature, occurrences, substitute, subsume, block, elim, phases };
+  double time[phases]                      = { }; // seconds per phase
+  Hardware hardware[phases];                      // hardware events per phase (see 'modes.perf')
+  size_t bytes_clauses                     = 0; // clause store (see 'measure_memory')
+  size_t bytes_occurrences                 = 0; // occurrence lists
+  size_t bytes_marks                       = 0; // variable indexed mark arrays
   std::chrono::time_point<std::chrono::high_resolution_clock> time_start;                                  // solving time (start)
   std::chrono::time_point<std::chrono::high_resolution_clock> time_end;                                    // solving time (end)
   std::chrono::time_point<std::chrono::high_resolution_clock> preprocess_start;                            // preprocessing time (start)
   std::chrono::time_point<std::chrono::high_resolution_clock> preprocess_end;                              // preprocessing time (end)
+
+/* Visit all counters as ('name', counter) pairs */
+  template <class S, class F>
+  static void visit (S& s, F f) {
+    f ("block_checks", s.block_checks);
+    f ("block_clauses", s.block_clauses);
+    f ("block_hash_match", s.block_hash_match);
+    f ("block_ticks", s.block_ticks);
+    f ("covered", s.covered);
+    f ("elim_hashes", s.elim_hashes);
+    f ("eliminated", s.eliminated);
+    f ("elim_hash_matches", s.elim_hash_matches);
+    f ("elim_checks", s.elim_checks);
+    f ("elim_gates", s.elim_gates);
+    f ("elim_resolvents", s.elim_resolvents);
+    f ("elim_ticks", s.elim_ticks);
+    f ("restored", s.restored);
+    f ("stopped", s.stopped);
+    f ("strengthened", s.strengthened);
+    f ("substituted", s.substituted);
+    f ("subsume_checks", s.subsume_checks);
+    f ("subsume_hash_matches", s.subsume_hash_matches);
+    f ("subsumed", s.subsumed);
+    f ("subsume_ticks", s.subsume_ticks);
+    f ("timeouts", s.timeouts);
+    f ("unfiltered", s.unfiltered);
+  }
+
+/* Named counters (for reports) */
+  std::vector<std::pair<const char*, long>> counters ( ) const {
+    std::vector<std::pair<const char*, long>> named;
+    visit (*this, [&named] (const char* name, const long& value) { named.push_back ({ name, value }); });
+    return named;
+  }
+
+/* Named phase times in seconds (for reports) */
+  static const char* phase_name (const int phase) {
+    static const char* names[phases] = { "parse", "signature", "occurrences", "substitute", "subsume", "block", "elim" };
+    return names[phase];
+  }
+  std::vector<std::pair<const char*, double>> times ( ) const {
+    std::vector<std::pair<const char*, double>> named;
+    for (int phase = 0; phase < phases; ++phase)
+      named.push_back ({ phase_name (phase), time[phase] });
+    return named;
+  }
+
+/* Named memory figures in bytes (for reports) */
+  std::vector<std::pair<const char*, size_t>> bytes ( ) const {
+    return { { "clauses", bytes_clauses },
+             { "occurrences", bytes_occurrences },
+             { "marks", bytes_marks } };
+  }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,181 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+#include "solver.h"
+
+namespace sat {
+
+/*-------------------------------------------------------------------------+
+ | Main call to equivalent literal substitution. Literals on a cycle of    |
+ | binary clauses (a strongly connected component of the binary implication|
+ | graph) are equivalent and replaced by one representative literal of the |
+ | component, which removes their variables from the formula before        |
+ | subsumption, BCE and BVE scan the occurrence lists. Both directions of  |
+ | each equivalence are saved on the extension stack with the substituted  |
+ | literal as witness, so that models are reconstructed (and clauses       |
+ | restored) as for the other techniques. Frozen variables are never       |
+ | substituted. Finding the components and substituting are both linear.   |
+/*-------------------------------------------------------------------------*/
+void CDCL::substitute_call ( ) {
+
+  TraceScope trace ("substitute_call");
+  Timer timer = phase (Stats::substitute);
+  if (!substitute_find ( )) return;
+  if (state.inconsistent) return;
+
+/* Rewrite clauses (garbage clauses of earlier calls are skipped) and units.
+   Clauses appended by 'substitute_clause' are already substituted. */
+  const size_t size = original.size ( );
+  for (size_t i = 0; i < size; ++i)
+    if (!original[i]->garbage)
+      substitute_clause (original[i]);
+  for (int& lit : unit_clauses)
+    if (substitute (lit) != lit) {
+      lit = substitute (lit);
+      block[abs (lit)] = 0;
+    }
+
+/* Save the equivalences 'var = repr' for reconstruction */
+  for (int var = 1; var <= param.vars; ++var) {
+    const int repr = substitute (var);
+    if (repr == var) continue;
+    ++stats.substituted;
+    witnesses[var] = 1;
+    extension.insert (extension.end ( ), { var, -repr, 0, -var, repr, 0 });
+  }
+}
+
+/*-------------------------------------------------------------------------+
+ | Find the strongly connected components of the binary implication graph  |
+ | with an iterative version of Tarjan's algorithm. A binary clause 'a     |
+ | b' gives the edges '-a -> b' and '-b ->                                 |
+ | a'. The graph is stored as arrays of edges indexed by 'widx' of the     |
+ | source literal. Since components come in complementary pairs, the       |
+ | representative of the component completed later is the complement of the|
+ | one of the other. Otherwise the representative is a literal of a frozen |
+ | variable, or of the smallest variable. A component with complementary   |
+ | literals makes the formula inconsistent. Returns false if there are no  |
+ | equivalences.                                                           |
+/*-------------------------------------------------------------------------*/
+bool CDCL::substitute_find ( ) {
+
+  const int nodes = 2*param.vars + 2;
+
+/* Implication graph */
+  std::vector<int> first (nodes + 1, 0), edges;
+  size_t binaries = 0;
+  for (const Clause* c : original)
+    if (!c->garbage && c->size ( ) == 2) {
+      ++first[widx (-c->lits[0])], ++first[widx (-c->lits[1])];
+      ++binaries;
+    }
+  if (!binaries) return false;
+  for (int n = 1; n <= nodes; ++n) first[n] += first[n - 1];
+  edges.resize (first[nodes]);
+  for (const Clause* c : original)
+    if (!c->garbage && c->size ( ) == 2) {
+      edges[--first[widx (-c->lits[0])]] = c->lits[1];
+      edges[--first[widx (-c->lits[1])]] = c->lits[0];
+    }
+
+/* Tarjan's algorithm with explicit stacks. 'order' is the visiting order
+   (0 if not visited yet) and 'reprs' is set once a component is complete */
+  reprs.assign (nodes, 0);
+  std::vector<int> order (nodes, 0), low (nodes, 0), next (nodes, 0);
+  std::vector<int> work, component;
+  int visited = 0;
+  bool equivalent = false;
+  for (int root = 2; root < nodes; ++root) {
+    if (order[root]) continue;
+    order[root] = low[root] = ++visited;
+    next[root] = first[root];
+    work.push_back (root), component.push_back (root);
+    while (!work.empty ( )) {
+      const int n = work.back ( );
+
+    /* Visit the next successor of 'n' */
+      if (next[n] < first[n + 1]) {
+        const int m = widx (edges[next[n]++]);
+        if (!order[m]) {
+          order[m] = low[m] = ++visited;
+          next[m] = first[m];
+          work.push_back (m), component.push_back (m);
+        } else if (!reprs[m]) low[n] = std::min (low[n], order[m]);
+        continue;
+      }
+      work.pop_back ( );
+      if (!work.empty ( )) low[work.back ( )] = std::min (low[work.back ( )], low[n]);
+      if (low[n] != order[n]) continue;
+
+    /* 'n' is the root of a component: choose its representative */
+      size_t start = component.size ( ) - 1;
+      while (component[start] != n) --start;
+      int repr = reprs[n ^ 1] ? -reprs[n ^ 1] : 0;
+      for (size_t i = start; !reprs[n ^ 1] && i < component.size ( ); ++i) {
+        const int lit = component[i] & 1 ? component[i] >> 1 : -(component[i] >> 1);
+        if (!repr || frozen (lit) > frozen (repr) || (frozen (lit) == frozen (repr) && abs (lit) < abs (repr)))
+          repr = lit;
+      }
+      for (size_t i = start; i < component.size ( ); ++i)
+        reprs[component[i]] = repr;
+      for (size_t i = start; i < component.size ( ); ++i)
+        if (reprs[component[i] ^ 1] == repr) state.inconsistent = true;
+      equivalent = equivalent || component.size ( ) - start > 1;
+      component.resize (start);
+    }
+  }
+  return equivalent;
+}
+
+/*-------------------------------------------------------------------------+
+ | Replace the literals of 'c' by their representatives. Duplicated        |
+ | literals are removed, tautologies (implied by the equivalences) are     |
+ | removed and unit clauses are moved to the unit clauses. With a          |
+ | persistent index (see 'incremental.cpp') 'c' is replaced by a new       |
+ | clause, which is then inserted like any other added clause, otherwise it|
+ | is rewritten in place and its signature recomputed.                     |
+/*-------------------------------------------------------------------------*/
+void CDCL::substitute_clause (Clause* c) {
+
+  add_lits.clear ( );
+  bool changed = false;
+  for (const int lit : *c) {
+    add_lits.push_back (substitute (lit));
+    changed = changed || add_lits.back ( ) != lit;
+  }
+  if (!changed) return;
+  if (tautology (add_lits)) { mark_garbage (c); return; }
+  if (add_lits.size ( ) == 1) {
+    unit_clauses.push_back (add_lits[0]);
+    block[abs (add_lits[0])] = 0;
+    mark_garbage (c);
+  } else if (occurring ( )) {
+    mark_garbage (c);
+    original.push_back (new_clause (add_lits));
+  } else {
+    std::copy (add_lits.begin ( ), add_lits.end ( ), c->begin ( ));
+    c->length = add_lits.size ( );
+    sort_lits (c);
+    compute_hash (c);
+  }
+}
+
+} // End namespace sat
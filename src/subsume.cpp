@@ -31,6 +31,7 @@ namespace sat {
 /*-------------------------------------------------------------------------*/
 bool CDCL::subsume_forward ( ) {
 
+  TraceScope trace ("subsume_forward");
   assert (candsizes.empty ( ));
   const bool hash = modes.hash;
 
@@ -38,30 +39,124 @@ bool CDCL::subsume_forward ( ) {
   stats.preprocess_start = std::chrono::high_resolution_clock::now ( );
 
 /* Schedule (sorted) candidates for subsumption */
+  Timer timer = phase (Stats::subsume);
+  param.merge_size = subsume_merge_size ( );
   subsume_candidates ( );
   if (hash) init_occrs_hash ( );
   else      init_occrs ( );
 
-/* Check candidates in increasing order of size */
+/* Check candidates in increasing order of size (within the budget) */
   int candsmarked = 0;
+  budget_start (Stats::subsume);
 
   for (std::pair<Clause*,size_t>& cs : candsizes) {
     Clause* c = cs.first;
+    if (budget.exhausted ( )) break;
 
   /* Find the smallest occurrence list to watch 'c' */
     if (hash) {
       if (cs.second > 2) subsume_check_hash (c);
+      if (c->garbage) continue;
       const int lit = subsume_min_occrs_hash (c);
       occhash (lit).push_back (OccrsHash (c, c->hash, c->unique));
     } else {
       if (cs.second > 2) subsume_check (c);
+      if (c->garbage) continue;
       const int lit = subsume_min_occrs (c);
       occurs (lit).push_back (c);
     }
   }
+  candsizes.clear ( );
+  budget_stop (Stats::subsume);
   return true;
 }
 
+/*-------------------------------------------------------------------------+
+ | Incremental version of 'subsume_forward'. Only the clauses added since  |
+ | the last call are checked (in increasing order of size) against the     |
+ | persistent occurrence index and then inserted into it. The older        |
+ | (larger) clauses they subsume are removed by 'subsume_backward'.        |
+/*-------------------------------------------------------------------------*/
+void CDCL::subsume_incremental ( ) {
+
+  assert (candsizes.empty ( ));
+  param.merge_size = subsume_merge_size ( );
+  for (size_t i = param.original; i < original.size ( ); ++i)
+    if (!original[i]->garbage)
+      candsizes.push_back (std::pair<Clause*,size_t>(original[i], original[i]->size ( )));
+  subsume_schedule ( );
+
+/* Once the budget is exhausted the clauses are only inserted */
+  budget_start (Stats::subsume);
+  for (std::pair<Clause*,size_t>& cs : candsizes) {
+    Clause* c = cs.first;
+    if (cs.second > 2 && cs.second <= lims.subsume_max_cls_size && !budget.exhausted ( )) {
+      if (modes.hash) subsume_check_hash (c);
+      else            subsume_check (c);
+    }
+    if (c->garbage) continue;
+    add_occrs (c, lims.block_max_cls_size);
+    if (cs.second <= lims.subsume_max_cls_size && !budget.exhausted ( )) subsume_backward (c);
+  }
+  candsizes.clear ( );
+  budget_stop (Stats::subsume);
+  param.original = original.size ( );
+}
+
+/*-------------------------------------------------------------------------+
+ | Backward subsumption: remove the clauses in the occurrence index which  |
+ | are subsumed by 'c', e.g. after 'c' was added as a new clause or as a   |
+ | resolvent. Unlike the watch lists of 'subsume_forward', the index has to|
+ | hold each clause in the lists of all its literals (see 'add_occrs'). The|
+ | candidates are the clauses in the list of the literal of 'c' with the   |
+ | fewest occurrences. With signatures, a candidate without some variable  |
+ | of 'c' in its signature ('c->hash & ~d->hash') is skipped before its    |
+ | literals are compared. Returns the number of removed clauses.           |
+/*-------------------------------------------------------------------------*/
+int CDCL::subsume_backward (const Clause* c) {
+
+/* Find the rarest literal */
+  int minlit = 0;
+  size_t minsize = UINTMAX_MAX;
+  for (const int lit : *c) {
+    const size_t size = modes.hash ? occhash (lit).size ( ) : occurs (lit).size ( );
+    if (size >= minsize) continue;
+    minlit = lit;
+    minsize = size;
+  }
+
+/* Candidates have to contain every literal of 'c' */
+  int removed = 0;
+  long ticks = c->size ( );
+  Count checks;
+  Count matches;
+  auto remove = [&] (Clause* d) {
+    ++removed;
+    if (modes.apply) mark_garbage (d);
+  };
+  mark_sign (c);
+  const int size = c->size ( );
+  const uint64_t hash = c->hash;
+  const size_t noccs = modes.hash ? occhash (minlit).size ( ) : occurs (minlit).size ( );
+  for (size_t i = 0; i < noccs; ++i) {
+    ++checks;
+    if (modes.hash && (hash & ~occhash (minlit)[i].hash)) { ++matches; continue; }
+    Clause* d = modes.hash ? occhash (minlit)[i].c : occurs (minlit)[i];
+    if (d == c || d->garbage || d->size ( ) < size) continue;
+    ticks += 1 + d->size ( );
+    int count = 0;
+    for (const int lit : *d)
+      count += sign_marked (lit) > 0;
+    if (count == size) remove (d);
+  }
+  unmark (c);
+  budget.tick (ticks + noccs);
+  checks.flush (stats.subsume_checks);          // statistics
+  matches.flush (stats.subsume_hash_matches);   // statistics
+  stats.subsumed += removed;
+  return removed;
+}
+
 /*-------------------------------------------------------------------------+
  | Collect candidates clauses for subsumption and sort.                    |
 /*-------------------------------------------------------------------------*/
@@ -72,7 +167,35 @@ void CDCL::subsume_candidates ( ) {
   subsume_find_candidates (original);
 
 /* Sort candidates by cardinality */
-  std::sort (candsizes.begin ( ), candsizes.end ( ), Sort_cls_size_subsume ( ));
+  subsume_schedule ( );
+}
+
+/*-------------------------------------------------------------------------+
+ | Order the candidates in 'candsizes' by increasing size. Sizes are small |
+ | (at most 'lims.subsume_max_cls_size' in 'subsume_forward'), so instead  |
+ | of sorting, the candidates are distributed over one bucket per size in  |
+ | two linear passes (counting sort), which keeps the original order of    |
+ | candidates of the same size.                                            |
+/*-------------------------------------------------------------------------*/
+void CDCL::subsume_schedule ( ) {
+
+/* Count candidates per size */
+  size_t max_size = 0;
+  for (const std::pair<Clause*,size_t>& cs : candsizes)
+    max_size = std::max (max_size, cs.second);
+  candcounts.assign (max_size + 2, 0);
+  for (const std::pair<Clause*,size_t>& cs : candsizes)
+    ++candcounts[cs.second + 1];
+
+/* Start of the bucket of each size */
+  for (size_t size = 1; size <= max_size; ++size)
+    candcounts[size] += candcounts[size - 1];
+
+/* Distribute candidates */
+  candbuckets.resize (candsizes.size ( ));
+  for (const std::pair<Clause*,size_t>& cs : candsizes)
+    candbuckets[candcounts[cs.second]++] = cs;
+  candsizes.swap (candbuckets);
 }
 
 /*-------------------------------------------------------------------------+
@@ -81,7 +204,7 @@ void CDCL::subsume_candidates ( ) {
 void CDCL::subsume_find_candidates (std::vector<Clause*>& clauses) {
 
   for (Clause* c : clauses)
-    if (c->size ( ) <= lims.subsume_max_cls_size)
+    if (!c->garbage && c->size ( ) <= lims.subsume_max_cls_size)
       candsizes.push_back (std::pair<Clause*,size_t>(c, c->size ( )));
 }
 
@@ -89,21 +212,29 @@ void CDCL::subsume_find_candidates (std::vector<Clause*>& clauses) {
  | This is the subsumption check of my forward subsumption algorithm. It   |
  | checks whether 'c' is subsumed by or can be strengthened by some clause |
  | in 'occrs' (which at this point only contains smaller than or equally   |
- | long clauses as 'c').                                                   |
+ | long clauses as 'c'). The persistent index of incremental mode holds all|
+ | clauses, of which the larger ones are skipped by the size in their      |
+ | header (read anyway to skip garbage) before their literals are compared.|
 /*-------------------------------------------------------------------------*/
 void CDCL::subsume_check (Clause* c) {
 
-/* Mark literals in 'c' */
-  mark_sign (c);
+/* Mark literals in 'c' (long clauses are merged instead, see 'subsumed') */
+  if (param.merge_size && c->size ( ) >= param.merge_size) merging = c;
+  else mark_sign (c);
   Clause* sub = 0;
   int str = 0;
-  int checks = 0;
-  int matches = 0;
+  Count checks;
+  long ticks = c->size ( );
+  const bool persistent = occurring ( );        // index may contain garbage
+  const int size = c->size ( );
   
 /* Check for subsumption and strengthening candidates in the positive
    occurrences of literals in 'c' */
   for (const int& lit : *c) {
     for (Clause* d : occurs (lit)) {
+      ++checks;
+      if (persistent && (d->garbage || d->size ( ) > size)) continue;
+      ticks += 1 + d->size ( );
       str = subsumed (d);                   // check if subsumed
       if (str) { sub = d; goto found; }     // found candidate
     }
@@ -112,17 +243,24 @@ void CDCL::subsume_check (Clause* c) {
    occurrences of literals in 'c' */
   for (const int& lit : *c) {
     for (Clause* d : occurs (-lit)) {
+      ++checks;
+      if (persistent && (d->garbage || d->size ( ) > size)) continue;
+      ticks += 1 + d->size ( );
       str = subsumed (d);                   // check if 'd' strengthens 'c'
       if (str) { sub = d; goto found; }     // found candidate
     }
   }
 /* Unmark literals in 'c' */
   found:;
-  unmark (c);
+  if (merging) merging = 0;
+  else unmark (c);
+  budget.tick (ticks);
+  checks.flush (stats.subsume_checks);          // statistics
 
 /* Check if 'c' can be subsumed or strengthened */
   if (str == INT_MIN) ++stats.subsumed;         // 'sub' subsumes 'c'
   else if (str) ++stats.strengthened;           // 'str' strengthens 'c'
+  if (str && modes.apply) subsume_apply (c, str);
 }
 
 /*-------------------------------------------------------------------------+
@@ -135,57 +273,113 @@ void CDCL::subsume_check (Clause* c) {
 /*-------------------------------------------------------------------------*/
 void CDCL::subsume_check_hash (Clause* c) {
 
-/* Mark literals in 'c' */
-  mark_sign (c);
-  Clause* sub = 0;
+/* Mark literals in 'c' (long clauses are merged instead, see 'subsumed') */
+  if (param.merge_size && c->size ( ) >= param.merge_size) merging = c;
+  else mark_sign (c);
+  budget.tick (c->size ( ));
   int str = 0;
-  int checks = 0;
-  int matches = 0;
+  Count checks;
+  Count matches;
   const uint64_t chash = ~c->hash;
   const uint64_t cunique = ~c->unique;
   
 /* Check for subsumption and strengthening candidates in the positive
    occurrences of literals in 'c' */
-  for (const int& lit : *c) {
-    for (const OccrsHash& chu : occhash (lit)) {
-      //++checks;
-      if (chu.hash & chash) continue;
-      if (chu.unique & cunique) continue;
-      //if (chu.hash & chash) { ++matches; continue; }
-      //if (chu.unique & cunique) { ++matches; continue; }
-      str = subsumed (chu.c);                   // check if subsumed
-      if (str) { sub = chu.c; goto found; }     // found candidate
-    }
-  }
+  for (const int& lit : *c)
+    if ((str = subsume_occs_hash (lit, c->size ( ), chash, cunique, checks, matches)))
+      goto found;
+
 /* Further check for strengthening candidates in the negative
    occurrences of literals in 'c' */
-  for (const int& lit : *c) {
-    for (const OccrsHash& chu : occhash (-lit)) {
-      //++checks;
-      if (chu.hash & chash) continue;
-      if (chu.unique & cunique) continue;
-      //if (chu.hash & chash) { ++matches; continue; }
-      //if (chu.unique & cunique) { ++matches; continue; }
-      str = subsumed (chu.c);                   // check if 'd' strengthens 'c'
-      if (str) { sub = chu.c; goto found; }     // found candidate
-    }
-  }
+  for (const int& lit : *c)
+    if ((str = subsume_occs_hash (-lit, c->size ( ), chash, cunique, checks, matches)))
+      goto found;
+
 /* Unmark literals in 'c' */
   found:;
-  unmark (c);
-  //stats.subsume_checks += checks;               // statistics
-  //stats.subsume_hash_matches += matches;        // statistics
+  if (merging) merging = 0;
+  else unmark (c);
+  checks.flush (stats.subsume_checks);          // statistics
+  matches.flush (stats.subsume_hash_matches);   // statistics
 
 /* Check if 'c' can be subsumed or strengthened */
   if (str == INT_MIN) ++stats.subsumed;         // 'sub' subsumes 'c'
   else if (str) ++stats.strengthened;           // 'str' strengthens 'c'
+  if (str && modes.apply) subsume_apply (c, str);
+}
+
+/*-------------------------------------------------------------------------+
+ | Check the occurrences of 'lit' for a clause which subsumes or           |
+ | strengthens the marked clause of 'size' literals with complemented      |
+ | signatures 'nhash' and 'nunique'. The signature filter runs on blocks of|
+ | 64 occurrences at once (see 'signature_mask' in 'kernels.h'), or not at |
+ | all on lists where it does not pay off (see 'Adaptive'). Candidates     |
+ | passing the filter are also rejected by the marks of their first        |
+ | literals (see 'OccrsHash'), and the clauses of the others are prefetched|
+ | before their literals are compared. Returns the result of 'subsumed'.   |
+/*-------------------------------------------------------------------------*/
+int CDCL::subsume_occs_hash (const int lit, const int size, const uint64_t nhash, const uint64_t nunique,
+                             Count& checks, Count& matches) {
+
+  const std::vector<OccrsHash>& occs = occhash (lit);
+  const bool persistent = occurring ( );        // index may contain garbage
+  const OccrsHash* block = occs.data ( );
+  const Adaptive::Choice choice = modes.adaptive ? adapt_subsume.choose (occs.size ( )) : Adaptive::filter;
+
+/* Plain marking if the filter rejects too few candidates of such lists */
+  if (choice == Adaptive::plain) {
+    ++stats.unfiltered;
+    for (const OccrsHash& chu : occs) {
+      ++checks;
+      if (persistent && (chu.c->garbage || chu.c->size ( ) > size)) continue;
+      budget.tick (1 + chu.c->size ( ));
+      const int str = subsumed (chu.c);
+      if (str) return str;
+    }
+    return 0;
+  }
+
+  for (size_t i = 0; i < occs.size ( ); i += 64, block += 64) {
+    const size_t n = std::min<size_t> (64, occs.size ( ) - i);
+    uint64_t mask = kernels ( ).signature_mask (block, n, nhash, nunique);
+    budget.tick (n);
+
+  /* Candidates with a first literal whose variable is not in the marked
+     clause, or with both negated in it, are rejected as well, and the
+     clauses of the others prefetched */
+    for (uint64_t m = mask; m; m &= m - 1) {
+      const int j = __builtin_ctzll (m);
+      const int sign0 = subsume_sign (block[j].lits[0]);
+      const int sign1 = subsume_sign (block[j].lits[1]);
+      if (!sign0 || !sign1 || (sign0 < 0 && sign1 < 0)) mask &= ~(1ULL << j);
+      else __builtin_prefetch (block[j].c);
+    }
+    for (uint64_t m = mask; m; m &= m - 1) {
+      const int j = __builtin_ctzll (m);
+      if (persistent && (block[j].c->garbage || block[j].c->size ( ) > size)) continue;
+      budget.tick (block[j].c->size ( ));
+      const int str = subsumed (block[j].c);
+      if (!str) continue;
+      const int rejected = j + 1 - __builtin_popcountll (mask & ((2ULL << j) - 1));
+      checks += j + 1;                          // statistics
+      matches += rejected;
+      if (choice == Adaptive::sample) adapt_subsume.record (occs.size ( ), j + 1, rejected);
+      return str;
+    }
+    checks += n;
+    matches += n - __builtin_popcountll (mask);
+    if (choice == Adaptive::sample) adapt_subsume.record (occs.size ( ), n, n - __builtin_popcountll (mask));
+  }
+  return 0;
 }
 
 /*-------------------------------------------------------------------------+
  | This is the true hot-spot of the subsumption algorithm. In order to che-|
  | ck whether 'c' subsumes the exterior (marked) clause, we have to compare|
- | the signs of literals in 'c', which involves accessing the mark through |
- | 'sign_marked', which merely returns the saved sign.                     |
+ | the signs of literals in 'c', which involves accessing the marks, which |
+ | merely hold the saved sign. The check itself is the 'subsumed' kernel   |
+ | (see 'kernels.cpp'). Long exterior clauses ('merging') are compared     |
+ | by 'subsumed_merge' instead.                                            |
  | Fuction :                                                               |
  | Returns INT_MIN if 'c' is subsumed.                                     |
  | Returns 'str' (literal to strengthen) if 'str' strengthens 'c'.         |
@@ -193,16 +387,62 @@ void CDCL::subsume_check_hash (Clause* c) {
 /*-------------------------------------------------------------------------*/
 int CDCL::subsumed (const Clause* c) {
 
+  if (merging) return subsumed_merge (merging, c);
+  return kernels ( ).subsumed (bmark, c->begin ( ), c->size ( ));
+}
+
+/*-------------------------------------------------------------------------+
+ | Same result as 'subsumed' for 'd' against the exterior clause 'c', but  |
+ | without marks. Both clauses are sorted by variable (see 'sort_lits'),   |
+ | so each literal of 'd' is searched in the rest of 'c' behind the one    |
+ | found before. This only reads the literals of 'c', which stay in the    |
+ | cache, while a mark is a random access into an array of '2 * vars'      |
+ | bytes (a cache miss on large instances).                                |
+/*-------------------------------------------------------------------------*/
+static bool var_below (const int lit, const int var) { return abs (lit) < var; }
+
+int CDCL::subsumed_merge (const Clause* c, const Clause* d) {
+
+  const int* p = c->begin ( );
+  const int* end = c->end ( );
   int str = 0;
-  for (const int& lit : *c) {
-    const signed char sign = sign_marked (lit);
-    if (!sign) return 0;                      // 'lit' unmarked
-    else if (sign > 0) continue;              // 'lit' mark is positive
-    else if (str) return 0;                   // two negated literals
-    else str = lit;                           // strengthening literal
+  for (const int lit : *d) {
+    const int var = abs (lit);
+    p = std::lower_bound (p, end, var, var_below);
+    if (p == end || abs (*p) != var) return 0;  // 'lit' not in 'c'
+    if (*p != lit) {
+      if (str) return 0;                        // two negated literals
+      str = lit;                                // strengthening literal
+    }
+    ++p;
   }
-  if (!str) return INT_MIN;                   // subsumption
-  return str;                                 // strengthen
+  return str ? str : INT_MIN;
+}
+
+/*-------------------------------------------------------------------------+
+ | Mark of 'lit' in the exterior clause: 1 if it contains 'lit', -1 if it  |
+ | contains '-lit' and 0 otherwise. A merged clause is not marked, so the  |
+ | literal is searched in it instead.                                      |
+/*-------------------------------------------------------------------------*/
+int CDCL::subsume_sign (const int lit) {
+
+  if (!merging) return sign_marked (lit);
+  const int* p = std::lower_bound (merging->begin ( ), merging->end ( ), abs (lit), var_below);
+  if (p == merging->end ( ) || abs (*p) != abs (lit)) return 0;
+  return *p == lit ? 1 : -1;
+}
+
+/*-------------------------------------------------------------------------+
+ | Size from which 'subsume_check' merges clauses instead of marking them  |
+ | (0 for never), as set by 'modes.merge'. Adaptively (-1), clauses of at  |
+ | least 'lims.subsume_merge_size' literals are merged once the mark array |
+ | exceeds 'lims.subsume_merge_marks' bytes, since marks only miss the     |
+ | cache on large instances and merging costs more than a hit.             |
+/*-------------------------------------------------------------------------*/
+int CDCL::subsume_merge_size ( ) {
+
+  if (modes.merge >= 0) return modes.merge;
+  return 2L * param.vars + 1 > lims.subsume_merge_marks ? lims.subsume_merge_size : 0;
 }
 
 /*-------------------------------------------------------------------------+
@@ -237,4 +477,22 @@ int CDCL::subsume_min_occrs_hash (const Clause* c) {
   return minlit;
 }
 
+/*-------------------------------------------------------------------------+
+ | Remove 'c' if it is subsumed ('str' is INT_MIN) or otherwise remove the |
+ | literal '-str' from 'c'. Strengthened unit clauses are moved to the     |
+ | unit clauses.                                                           |
+/*-------------------------------------------------------------------------*/
+void CDCL::subsume_apply (Clause* c, const int str) {
+
+  if (str == INT_MIN) { mark_garbage (c); return; }
+  int* j = c->begin ( );
+  for (const int lit : *c)
+    if (lit != -str) *j++ = lit;
+  c->length = j - c->begin ( );
+  compute_hash (c);
+  if (c->size ( ) > 1) return;
+  unit_clauses.push_back (c->lits[0]);
+  mark_garbage (c);
+}
+
 } //End namespace sat
\ No newline at end of file
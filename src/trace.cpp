@@ -0,0 +1,135 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+
+#include "trace.h"
+
+namespace sat {
+
+bool Trace::active = false;
+
+static std::mutex trace_mutex;                                  // protects the state below
+static std::string trace_path;                                  // output file
+static std::vector<std::unique_ptr<Trace::Buffer>>* trace_buffers = 0;
+static std::chrono::steady_clock::time_point trace_epoch;       // time of 'start'
+
+/*-------------------------------------------------------------------------+
+ | Write the trace at exit.                                                |
+/*-------------------------------------------------------------------------*/
+static void trace_at_exit ( ) { Trace::write ( ); }
+
+/*-------------------------------------------------------------------------+
+ | Start tracing into 'path_'. The trace is written at exit.               |
+/*-------------------------------------------------------------------------*/
+void Trace::start (const std::string& path_) {
+
+  std::lock_guard<std::mutex> lock (trace_mutex);
+  if (active) return;
+  trace_path = path_;
+  if (!trace_buffers) trace_buffers = new std::vector<std::unique_ptr<Buffer>> ( );
+  trace_epoch = std::chrono::steady_clock::now ( );
+  atexit (trace_at_exit);
+  active = true;
+}
+
+/*-------------------------------------------------------------------------+
+ | Enable tracing from the environment ('SAT_TRACE=<file>').               |
+/*-------------------------------------------------------------------------*/
+static struct TraceEnvironment {
+  TraceEnvironment ( ) {
+    const char* path = getenv ("SAT_TRACE");
+    if (path && *path) Trace::start (path);
+  }
+} trace_environment;
+
+/*-------------------------------------------------------------------------+
+ | Ring buffer of the calling thread. Buffers are owned by the registry    |
+ | and outlive their threads, so the events of finished workers are kept.  |
+/*-------------------------------------------------------------------------*/
+Trace::Buffer* Trace::local ( ) {
+
+  thread_local Buffer* buffer = 0;
+  if (buffer) return buffer;
+  std::lock_guard<std::mutex> lock (trace_mutex);
+  trace_buffers->emplace_back (new Buffer ( ));
+  buffer = trace_buffers->back ( ).get ( );
+  buffer->events.resize (capacity);
+  buffer->tid = trace_buffers->size ( );
+  return buffer;
+}
+
+/*-------------------------------------------------------------------------+
+ | Record a begin ('B') or end ('E') event of 'name'.                      |
+/*-------------------------------------------------------------------------*/
+void Trace::event (const char* name, const char phase) {
+
+  Buffer* buffer = local ( );
+  Event& event = buffer->events[buffer->next++ % capacity];
+  event.name = name;
+  event.time = std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now ( ) - trace_epoch).count ( );
+  event.phase = phase;
+}
+
+/*-------------------------------------------------------------------------+
+ | Write all buffers in the Chrome trace event format. End events whose    |
+ | begin was overwritten in the ring buffer are dropped.                   |
+/*-------------------------------------------------------------------------*/
+bool Trace::write ( ) {
+
+  std::lock_guard<std::mutex> lock (trace_mutex);
+  if (!active) return false;
+  std::ofstream out (trace_path);
+  if (!out) {
+    std::cout << "WARNING: could not write trace '" << trace_path << "'" << std::endl;
+    return false;
+  }
+  const int pid = getpid ( );
+  const char* separator = "";
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (const std::unique_ptr<Buffer>& buffer : *trace_buffers) {
+    out << separator << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+        << ",\"args\":{\"name\":\"thread " << buffer->tid << "\"}}";
+    separator = ",";
+    const size_t first = buffer->next > capacity ? buffer->next - capacity : 0;
+    int depth = 0;
+    for (size_t i = first; i < buffer->next; ++i) {
+      const Event& event = buffer->events[i % capacity];
+      if (event.phase == 'B') ++depth;
+      else if (!depth) continue;
+      else --depth;
+      char ts[32];
+      snprintf (ts, sizeof ts, "%.3f", event.time / 1e3);
+      out << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"" << event.phase << "\",\"ts\":" << ts
+          << ",\"pid\":" << pid << ",\"tid\":" << buffer->tid << "}";
+    }
+  }
+  out << "\n]}\n";
+  return (bool) out;
+}
+
+} //End namespace sat
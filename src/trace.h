@@ -0,0 +1,93 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+
+/*-------- General includes ----------------------------------------*/
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifndef TRACE_H
+#define TRACE_H
+
+namespace sat {
+
+/*-------------------------------------------------------------------------+
+ | Timeline of preprocessing phases in the Chrome trace event format       |
+ | (viewable in Perfetto or chrome://tracing). Tracing is enabled by       |
+ | setting the environment variable 'SAT_TRACE' to the output file (or by  |
+ | calling 'start'). Each thread records begin/end events into its own ring|
+ | buffer of 'capacity' events, so recording takes no lock and a long run  |
+ | keeps its most recent events. All buffers are written as JSON when the  |
+ | process exits (or on 'write'). Without tracing a 'TraceScope' costs a   |
+ | single test.                                                            |
+/*-------------------------------------------------------------------------*/
+class Trace {
+
+  public:
+
+    static bool enabled ( ) { return active; }
+    static void start (const std::string& path_);
+    static void event (const char* name, const char phase);
+    static bool write ( );
+
+    static const size_t capacity = 1 << 16;  // events per thread
+
+    struct Event {
+      const char* name;                      // static string
+      int64_t time;                          // nanoseconds since 'start'
+      char phase;                            // 'B'egin or 'E'nd
+    };
+
+    struct Buffer {
+      std::vector<Event> events;             // ring buffer
+      size_t next = 0;                       // number of recorded events
+      int tid = 0;                           // thread number
+    };
+
+  private:
+
+    static Buffer* local ( );
+
+    static bool active;                      // tracing enabled
+};
+
+/*-------------------------------------------------------------------------+
+ | Records a begin event for 'name' and the matching end event when it     |
+ | goes out of scope. 'name' must be a string literal.                     |
+/*-------------------------------------------------------------------------*/
+class TraceScope {
+
+  public:
+
+    TraceScope (const char* name_) : name {Trace::enabled ( ) ? name_ : 0} { if (name) Trace::event (name, 'B'); }
+    ~TraceScope ( ) { if (name) Trace::event (name, 'E'); }
+    TraceScope (const TraceScope&) = delete;
+    TraceScope& operator= (const TraceScope&) = delete;
+
+  private:
+
+    const char* name;                        // traced scope (0 if disabled)
+};
+
+} //End namespace sat
+
+#endif
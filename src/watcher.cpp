@@ -26,13 +26,15 @@ namespace sat {
 
 
 /*-------------------------------------------------------------------------+
- | Initialize empty occurence list.                                        |
+ | Initialize empty occurence list. The lists are only grown and cleared   |
+ | (see 'reset_occrs'), so their capacity is reused by later instances.    |
 /*-------------------------------------------------------------------------*/
 void CDCL::init_occrs ( ) {
 
-  assert (occrs.empty ( ));
-  occrs.resize (param.lits + 2, std::vector<Clause*> ( ));
-  assert (occrs.size ( ) == param.lits + 2);
+  TraceScope trace ("init_occrs");
+  if (occrs.size ( ) < param.lits + 2)
+    occrs.resize (param.lits + 2, std::vector<Clause*> ( ));
+  assert (occrs.size ( ) >= param.lits + 2);
 }
 
 /*-------------------------------------------------------------------------+
@@ -40,9 +42,10 @@ void CDCL::init_occrs ( ) {
 /*-------------------------------------------------------------------------*/
 void CDCL::init_occrs_hash ( ) {
 
-  assert (occrshash.empty ( ));
-  occrshash.resize (param.lits + 2, std::vector<OccrsHash> ( ));
-  assert (occrshash.size ( ) == param.lits + 2);
+  TraceScope trace ("init_occrs_hash");
+  if (occrshash.size ( ) < param.lits + 2)
+    occrshash.resize (param.lits + 2, std::vector<OccrsHash> ( ));
+  assert (occrshash.size ( ) >= param.lits + 2);
 }
 
 /*-------------------------------------------------------------------------+
@@ -50,9 +53,81 @@ void CDCL::init_occrs_hash ( ) {
 /*-------------------------------------------------------------------------*/
 void CDCL::init_ohu ( ) {
 
-  assert (ohu.empty ( ));
-  ohu.resize (param.lits + 2, std::vector<std::pair<uint64_t,uint64_t>> ( ));
-  assert (ohu.size ( ) == param.lits + 2);
+  if (ohu.size ( ) < param.lits + 2)
+    ohu.resize (param.lits + 2, std::vector<std::pair<uint64_t,uint64_t>> ( ));
+  assert (ohu.size ( ) >= param.lits + 2);
+}
+
+/*-------------------------------------------------------------------------+
+ | Remove garbage clauses from the occurrence list of 'lit'.               |
+/*-------------------------------------------------------------------------*/
+void CDCL::flush_occrs (const int lit) {
+
+  if (modes.hash) {
+    std::vector<OccrsHash>& occs = occhash (lit);
+    occs.erase (std::remove_if (occs.begin ( ), occs.end ( ),
+      [] (const OccrsHash& chu) { return chu.c->garbage; }), occs.end ( ));
+  } else {
+    std::vector<Clause*>& occs = occurs (lit);
+    occs.erase (std::remove_if (occs.begin ( ), occs.end ( ),
+      [] (const Clause* c) { return c->garbage; }), occs.end ( ));
+  }
+}
+
+/*-------------------------------------------------------------------------+
+ | Add 'c' to the occurrence lists of its literals. Variables of clauses   |
+ | larger than 'max_size' are excluded from BCE/BVE instead.               |
+/*-------------------------------------------------------------------------*/
+void CDCL::add_occrs (Clause* c, const int max_size) {
+
+  if (occurring ( ))
+    for (const int lit : *c)
+      mark_dirty (lit);
+  if (c->size ( ) > max_size) {
+    for (const int lit : *c)
+      block[abs (lit)] = 0;
+  } else if (modes.hash) {
+    const OccrsHash chu (c, c->hash, c->unique);
+    for (const int lit : *c)
+      occhash (lit).push_back (chu);
+  } else {
+    for (const int lit : *c)
+      occurs (lit).push_back (c);
+  }
+}
+
+/*-------------------------------------------------------------------------+
+ | Is the resolvent of the marked clause (containing 'lit') and 'd' (in the|
+ | occurrences of '-lit') tautological by one of the literals in the entry |
+ | of 'd'? Then 'd' does not have to be loaded to check its other literals.|
+/*-------------------------------------------------------------------------*/
+bool CDCL::occurrence_clash (const OccrsHash& d, const int lit) {
+
+  return (d.lits[0] != -lit && sign_marked (d.lits[0]) < 0) || (d.lits[1] != -lit && sign_marked (d.lits[1]) < 0);
+}
+
+/*-------------------------------------------------------------------------+
+ | Remove garbage clauses from all occurrence lists.                       |
+/*-------------------------------------------------------------------------*/
+void CDCL::flush_occrs ( ) {
+
+  for (int lit = -param.vars; lit <= param.vars; ++lit)
+    if (lit) flush_occrs (lit);
+}
+
+/*-------------------------------------------------------------------------+
+ | Clear all occurence lists but keep their capacity. Only the lists of    |
+ | the current 'param.lits' literals can be non-empty.                     |
+/*-------------------------------------------------------------------------*/
+void CDCL::reset_occrs ( ) {
+
+  const size_t used = param.lits + 2;
+  for (size_t i = 0; i < std::min (used, occrs.size ( )); ++i) occrs[i].clear ( );
+  for (size_t i = 0; i < std::min (used, occrshash.size ( )); ++i) occrshash[i].clear ( );
+  for (size_t i = 0; i < std::min (used, ohu.size ( )); ++i) ohu[i].clear ( );
+  for (const int var : dirty_vars) dirty[var] = 0;
+  dirty_vars.clear ( );
+  state.occurring = false;
 }
 
 } //End namespace sat
\ No newline at end of file
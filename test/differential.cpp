@@ -0,0 +1,647 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+
+/*-------------------------------------------------------------------------+
+ | Differential test of the code paths of each technique. Every variant    |
+ | (see 'variants') simplifies generated instances with subsumption, BCE,  |
+ | BVE, all of them, BCE with CCE and all of them after substitution, and  |
+ | has to remove, strengthen and keep exactly the same clauses as the first|
+ | (plain) variant. A formula on which a variant differs is minimized      |
+ | (clauses first, then literals) and written to the output directory. The |
+ | DIMACS tokenizer is checked on the same instances with every kernel tier|
+ | (see 'kernels.h'), and so is 'signature_mask' on random occurrence lists|
+ | with full blocks. Equivalent literal substitution is checked by brute   |
+ | force on small formulas: the simplified formula is equisatisfiable and  |
+ | its models extend to models of the original formula (see                |
+ | 'reconstruct_mismatch'), and so are gate definitions in BVE on small    |
+ | formulas with an AND, if-then-else or XOR gate and on small circuits.   |
+ | Incremental calls with assumptions, frozen witnesses and clauses added  |
+ | in chunks are checked the same way, as is one call on the same formula. |
+ | Usage: sat_differential [instances] [directory]                         |
+/*-------------------------------------------------------------------------*/
+#include <fstream>
+#include <functional>
+
+/* User includes */
+#include "generate.h"
+#include "solver.h"
+
+typedef std::vector<std::vector<int>> CNF;
+
+/*-------------------------------------------------------------------------+
+ | Variants of the code paths, the first one is the reference. Faster      |
+ | kernels (vectorized or parallel) are added here before they are used.   |
+ | The signature paths run with every kernel tier the CPU supports.        |
+/*-------------------------------------------------------------------------*/
+struct Variant {
+  std::string name;
+  std::function<void (Modes&)> set;
+  ~Variant ( );                  // out of line, it is not worth inlining
+};
+
+Variant::~Variant ( ) { }
+
+static std::vector<Variant> kernel_variants ( ) {
+
+  std::vector<Variant> variants = {
+    { "plain", [] (Modes& modes) { modes.hash = false; sat::select_kernels ("scalar"); } } };
+  for (const std::string& tier : sat::available_kernels ( ))
+    variants.push_back ({ "hash/" + tier, [tier] (Modes& modes) { modes.hash = true; sat::select_kernels (tier); } });
+  const std::string best = sat::available_kernels ( )[0];
+  variants.push_back ({ "adaptive", [best] (Modes& modes) { modes.adaptive = true; sat::select_kernels (best); } });
+  variants.push_back ({ "merge", [] (Modes& modes) { modes.hash = false; modes.merge = 3; sat::select_kernels ("scalar"); } });
+  return variants;
+}
+
+static const std::vector<Variant> variants = kernel_variants ( );
+
+/*-------------------------------------------------------------------------+
+ | Outcome of simplification in normal form (literals and clauses sorted): |
+ | remaining clauses, units, removed clauses (witness first) and counters. |
+/*-------------------------------------------------------------------------*/
+struct Outcome {
+  CNF clauses;
+  std::vector<int> units;
+  CNF removed;
+  std::vector<long> counters;
+  bool operator== (const Outcome& o) const {
+    return clauses == o.clauses && units == o.units && removed == o.removed && counters == o.counters;
+  }
+  ~Outcome ( );                  // out of line, it is not worth inlining
+};
+
+Outcome::~Outcome ( ) { }
+
+static Outcome simplify (const CNF& cnf, Modes modes) {
+
+  sat::CDCL cdcl;
+  std::vector<int> lits;
+  for (const std::vector<int>& clause : cnf) {
+    lits.insert (lits.end ( ), clause.begin ( ), clause.end ( ));
+    lits.push_back (0);
+  }
+  cdcl.add_clauses (lits.data ( ), lits.size ( ));
+  cdcl.simplify (modes);
+
+  Outcome outcome;
+  for (const Clause& c : cdcl.clauses ( )) {
+    outcome.clauses.push_back (std::vector<int> (c.begin ( ), c.end ( )));
+    std::sort (outcome.clauses.back ( ).begin ( ), outcome.clauses.back ( ).end ( ));
+  }
+  outcome.units = cdcl.units ( );
+  const std::vector<int>& removed = cdcl.removed ( );
+  for (size_t i = 0; i < removed.size ( ); ++i) {
+    std::vector<int> clause;
+    for ( ; removed[i]; ++i) clause.push_back (removed[i]);
+    std::sort (clause.begin ( ) + 1, clause.end ( ));
+    outcome.removed.push_back (clause);
+  }
+  std::sort (outcome.clauses.begin ( ), outcome.clauses.end ( ));
+  std::sort (outcome.units.begin ( ), outcome.units.end ( ));
+  std::sort (outcome.removed.begin ( ), outcome.removed.end ( ));
+  outcome.counters = { cdcl.stats.subsumed, cdcl.stats.strengthened, cdcl.stats.block_clauses, cdcl.stats.eliminated,
+                       cdcl.stats.covered, cdcl.stats.substituted };
+  return outcome;
+}
+
+/*-------------------------------------------------------------------------+
+ | Index of the first variant which differs from the reference on 'cnf',   |
+ | or 0 if all agree.                                                      |
+/*-------------------------------------------------------------------------*/
+static size_t mismatch (const CNF& cnf, const Modes& modes) {
+
+  Modes reference = modes;
+  variants[0].set (reference);
+  const Outcome expected = simplify (cnf, reference);
+  for (size_t v = 1; v < variants.size ( ); ++v) {
+    Modes variant = modes;
+    variants[v].set (variant);
+    if (!(simplify (cnf, variant) == expected)) return v;
+  }
+  return 0;
+}
+
+/*-------------------------------------------------------------------------+
+ | Shrink 'cnf' while variant 'v' still differs: remove chunks of clauses  |
+ | of halving size (as in delta debugging) and then single literals.       |
+/*-------------------------------------------------------------------------*/
+static CNF minimize (CNF cnf, const Modes& modes, const size_t v) {
+
+  for (size_t chunk = cnf.size ( ) / 2; chunk; chunk /= 2) {
+    for (size_t i = 0; i < cnf.size ( ); ) {
+      CNF smaller (cnf.begin ( ), cnf.begin ( ) + i);
+      smaller.insert (smaller.end ( ), cnf.begin ( ) + std::min (cnf.size ( ), i + chunk), cnf.end ( ));
+      if (mismatch (smaller, modes) == v) cnf = smaller;
+      else i += chunk;
+    }
+  }
+  for (size_t i = 0; i < cnf.size ( ); ++i)
+    for (size_t j = 0; j < cnf[i].size ( ) && cnf[i].size ( ) > 1; ) {
+      CNF smaller = cnf;
+      smaller[i].erase (smaller[i].begin ( ) + j);
+      if (mismatch (smaller, modes) == v) cnf = smaller;
+      else ++j;
+    }
+  return cnf;
+}
+
+/*-------------------------------------------------------------------------+
+ | Print where the outcomes of the reference and variant 'v' differ.       |
+/*-------------------------------------------------------------------------*/
+static void print_diff (const CNF& cnf, const Modes& modes, const size_t v) {
+
+  Modes reference = modes, variant = modes;
+  variants[0].set (reference);
+  variants[v].set (variant);
+  const Outcome a = simplify (cnf, reference), b = simplify (cnf, variant);
+  auto clause = [] (const std::vector<int>& lits) {
+    std::string s;
+    for (const int lit : lits) s += std::to_string (lit) + " ";
+    return s + "0";
+  };
+  auto only = [&] (const CNF& xs, const CNF& ys, const char* what, const std::string& name) {
+    for (const std::vector<int>& x : xs)
+      if (std::find (ys.begin ( ), ys.end ( ), x) == ys.end ( ))
+        std::cout << "    " << what << " only by " << name << ": " << clause (x) << std::endl;
+  };
+  const char* names[] = { "subsumed", "strengthened", "blocked", "eliminated", "covered", "substituted" };
+  for (size_t i = 0; i < a.counters.size ( ); ++i)
+    if (a.counters[i] != b.counters[i])
+      std::cout << "    " << names[i] << ": " << variants[0].name << " " << a.counters[i] << ", "
+                << variants[v].name << " " << b.counters[i] << std::endl;
+  only (a.clauses, b.clauses, "kept", variants[0].name);
+  only (b.clauses, a.clauses, "kept", variants[v].name);
+  only (a.removed, b.removed, "removed (witness first)", variants[0].name);
+  only (b.removed, a.removed, "removed (witness first)", variants[v].name);
+  if (a.units != b.units) std::cout << "    units differ" << std::endl;
+}
+
+/*-------------------------------------------------------------------------+
+ | Write 'lits' as DIMACS with comment lines (also containing numbers) and |
+ | irregular white space, and check that every kernel tier tokenizes it to |
+ | 'lits'. Odd seeds append the SATLIB trailer '%' '0', which must not add |
+ | numbers. Returns the name of the first failing tier or an empty string. |
+/*-------------------------------------------------------------------------*/
+static std::string tokenize_mismatch (const std::vector<int>& lits, const int seed) {
+
+  std::mt19937_64 rng (seed);
+  const char* spaces[] = { " ", "  ", "\t", " \n", "\n" };
+  std::string text = "p cnf 0 0\n";
+  for (const int lit : lits) {
+    if (rng ( ) % 16 == 0) text += "\nc comment -12 34 c 50%\n";
+    text += std::to_string (lit) + spaces[rng ( ) % 5];
+  }
+  if (seed % 2) text += "\n%\n0\n\n";
+  const char* begin = text.data ( ) + 9;        // after the header
+  std::vector<int> numbers;
+  for (const std::string& tier : sat::available_kernels ( )) {
+    sat::select_kernels (tier);
+    sat::CDCL::tokenize (begin, text.data ( ) + text.size ( ), numbers);
+    if (numbers != lits) return tier;
+  }
+  return "";
+}
+
+/*-------------------------------------------------------------------------+
+ | Check 'signature_mask' of every kernel tier against its definition on a |
+ | random list of up to 200 occurrences, passed in blocks of 64 entries as |
+ | by the techniques (the instances above rarely fill a block). Returns the|
+ | name of the first failing tier or an empty string.                      |
+/*-------------------------------------------------------------------------*/
+static std::string signature_mismatch (const int seed) {
+
+  std::mt19937_64 rng (seed);
+  auto sparse = [&rng] ( ) { return rng ( ) & rng ( ) & rng ( ); };    // about eight bits set
+  Clause clause;
+  clause.lits[0] = 1, clause.lits[1] = 2;
+  std::vector<sat::OccrsHash> occs;
+  const size_t size = 1 + rng ( ) % 200;
+  for (size_t i = 0; i < size; ++i) occs.emplace_back (&clause, sparse ( ), sparse ( ) & sparse ( ));
+  const uint64_t hash = sparse ( ), unique = sparse ( );
+  for (const std::string& tier : sat::available_kernels ( )) {
+    sat::select_kernels (tier);
+    for (size_t i = 0; i < size; i += 64) {
+      const size_t n = std::min<size_t> (64, size - i);
+      uint64_t expected = 0;
+      for (size_t j = 0; j < n; ++j)
+        if (!((occs[i + j].hash & hash) | (occs[i + j].unique & unique))) expected |= 1ULL << j;
+      if (sat::kernels ( ).signature_mask (occs.data ( ) + i, n, hash, unique) != expected) return tier;
+    }
+  }
+  return "";
+}
+
+/*-------------------------------------------------------------------------+
+ | Brute force on formulas with at most 20 variables. An assignment is a   |
+ | bit set with bit 'var - 1' set if 'var' is true. 'solve' looks for the  |
+ | first model of 'cnf' from 'model' on which satisfies the literals       |
+ | 'assumed', and 'extend' turns a model of the simplified formula into one|
+ | of the original formula by going through the removed clauses in reverse |
+ | and flipping the witness (first literal) of each falsified clause.      |
+/*-------------------------------------------------------------------------*/
+static bool satisfies (const int lit, const uint32_t model) {
+
+  return (lit > 0) == bool (model >> (abs (lit) - 1) & 1);
+}
+
+static bool satisfies (const std::vector<int>& clause, const uint32_t model) {
+
+  for (const int lit : clause)
+    if (satisfies (lit, model)) return true;
+  return false;
+}
+
+static bool satisfies (const CNF& cnf, const uint32_t model) {
+
+  for (const std::vector<int>& clause : cnf)
+    if (!satisfies (clause, model)) return false;
+  return true;
+}
+
+static bool solve (const CNF& cnf, const int vars, const std::vector<int>& assumed, uint32_t& model) {
+
+  for (; model < 1u << vars; ++model) {
+    bool consistent = true;
+    for (const int lit : assumed) consistent = consistent && satisfies (lit, model);
+    if (consistent && satisfies (cnf, model)) return true;
+  }
+  return false;
+}
+
+static void extend (const std::vector<int>& removed, uint32_t& model) {
+
+  for (size_t end = removed.size ( ); end; ) {
+    size_t begin = end - 1;
+    while (begin && removed[begin - 1]) --begin;
+    const std::vector<int> clause (removed.begin ( ) + begin, removed.begin ( ) + end - 1);
+    if (!satisfies (clause, model)) model ^= 1u << (abs (clause[0]) - 1);
+    end = begin;
+  }
+}
+
+/*-------------------------------------------------------------------------+
+ | Check a call of 'simplify' on 'cnf' under 'assumed' which returned      |
+ | 'status': the remaining clauses and units of 'cdcl' have a model under  |
+ | 'assumed' iff 'cnf' has one, and the extension (see 'extend') of each of|
+ | their models satisfies 'cnf' and 'assumed'. All models are extended, so |
+ | that variables removed from the formula are checked with both values.   |
+ | Returns what failed or an empty string.                                 |
+/*-------------------------------------------------------------------------*/
+static std::string reconstruct_mismatch (const CNF& cnf, const int vars, const std::vector<int>& assumed,
+                                         const sat::CDCL& cdcl, const int status) {
+
+  CNF simplified;
+  for (const Clause& c : cdcl.clauses ( )) simplified.push_back (std::vector<int> (c.begin ( ), c.end ( )));
+  for (const int unit : cdcl.units ( )) simplified.push_back ({ unit });
+  uint32_t model = 0, first = 0;
+  const bool expected = solve (cnf, vars, assumed, model);
+  const bool found = status != 20 && solve (simplified, vars, assumed, first);
+  if (expected != found) return expected ? "satisfiable formula simplified to unsatisfiable" : "unsatisfiable formula simplified to satisfiable";
+  for (model = first; found && solve (simplified, vars, assumed, model); ++model) {
+    uint32_t extended = model;
+    extend (cdcl.removed ( ), extended);
+    if (!satisfies (cnf, extended)) return "extended model falsifies the formula";
+    for (const int lit : assumed)
+      if (!satisfies (lit, extended)) return "extended model falsifies assumption " + std::to_string (lit);
+  }
+  return "";
+}
+
+/*-------------------------------------------------------------------------+
+ | Simplify a random formula over at most 12 variables with equivalences   |
+ | (pairs of binary clauses, which form chains and cycles) and clauses of  |
+ | two to four literals by substitution (see 'substitute.cpp') and random  |
+ | other techniques, with assumptions and a frozen variable now and then,  |
+ | and check it by brute force. Adds the substituted variables to 'count'. |
+/*-------------------------------------------------------------------------*/
+static std::string substitute_mismatch (const int seed, long& count) {
+
+  std::mt19937_64 rng (seed);
+  const int vars = 6 + rng ( ) % 7;
+  auto literal = [&] ( ) { const int var = 1 + rng ( ) % vars; return rng ( ) % 2 ? var : -var; };
+  CNF cnf;
+  for (int i = 0, n = 2 + rng ( ) % vars; i < n; ++i) {
+    const int a = literal ( ), b = literal ( );
+    if (abs (a) != abs (b)) cnf.push_back ({ -a, b }), cnf.push_back ({ a, -b });
+  }
+  for (int i = 0, n = rng ( ) % (2 * vars); i < n; ++i) {
+    cnf.emplace_back ( );
+    for (int j = 0, size = 2 + rng ( ) % 3; j < size; ++j) cnf.back ( ).push_back (literal ( ));
+  }
+  std::shuffle (cnf.begin ( ), cnf.end ( ), rng);
+
+  sat::CDCL cdcl;
+  for (const std::vector<int>& clause : cnf) cdcl.add_clause (clause);
+  Modes modes;
+  modes.substitute = true;
+  modes.subsume = rng ( ) % 2, modes.block = rng ( ) % 2, modes.elim = rng ( ) % 2, modes.hash = rng ( ) % 2;
+  std::vector<int> assumed;
+  if (rng ( ) % 3 == 0) assumed.push_back (literal ( )), cdcl.assume (assumed.back ( ));
+  if (rng ( ) % 4 == 0) cdcl.freeze (literal ( ));
+  const int status = cdcl.simplify (modes);
+  count += cdcl.stats.substituted;
+  return reconstruct_mismatch (cnf, vars, assumed, cdcl, status);
+}
+
+/*-------------------------------------------------------------------------+
+ | Fixed cases of substitution: an inconsistent cycle '1 = 2 = -1' and the |
+ | equivalences saved for reconstruction of '1 = 2 = -3' without and with  |
+ | '3' frozen (which makes '3' the representative). Returns what failed or |
+ | an empty string.                                                        |
+/*-------------------------------------------------------------------------*/
+static std::string substitute_cases ( ) {
+
+  Modes modes;
+  modes.substitute = true, modes.block = false;
+  {
+    sat::CDCL cdcl;
+    for (const std::vector<int>& clause : CNF { { 1, 2 }, { -1, -2 }, { -1, 2 }, { 1, -2 } }) cdcl.add_clause (clause);
+    if (cdcl.simplify (modes) != 20) return "'1 = 2 = -1' not found inconsistent";
+  }
+  for (const bool frozen : { false, true }) {
+    sat::CDCL cdcl;
+    for (const std::vector<int>& clause : CNF { { 1, -2 }, { -1, 2 }, { 2, 3 }, { -2, -3 } }) cdcl.add_clause (clause);
+    if (frozen) cdcl.freeze (3);
+    const std::vector<int> expected = frozen ? std::vector<int> { 1, 3, 0, -1, -3, 0, 2, 3, 0, -2, -3, 0 }
+                                             : std::vector<int> { 2, -1, 0, -2, 1, 0, 3, 1, 0, -3, -1, 0 };
+    if (cdcl.simplify (modes) || cdcl.removed ( ) != expected || cdcl.clauses ( ).begin ( ) != cdcl.clauses ( ).end ( ))
+      return std::string ("wrong equivalences saved for '1 = 2 = -3'") + (frozen ? " with '3' frozen" : "");
+  }
+  return "";
+}
+
+/*-------------------------------------------------------------------------+
+ | Simplify by BVE a random formula over at most 12 variables in which the |
+ | last variable is defined by an AND, if-then-else or XOR gate ('kind' 0, |
+ | 1 or 2) of other variables and occurs in a few more clauses, or a small |
+ | generated circuit ('kind' 3), and check it by brute force (see          |
+ | 'reconstruct_mismatch'). Adds the gates found (see 'elim_find_gate') to |
+ | 'gates'.                                                                |
+/*-------------------------------------------------------------------------*/
+static std::string gate_mismatch (const int seed, const int kind, long& gates) {
+
+  std::mt19937_64 rng (seed);
+  CNF cnf;
+  int vars = 12;
+  if (kind == 3) {
+    sat::Formula formula;
+    sat::generate ("circuit", vars, seed, { { "inputs", 0.4 } }, formula);
+    cnf.emplace_back ( );
+    for (const int lit : formula.lits)
+      if (lit) cnf.back ( ).push_back (lit);
+      else cnf.emplace_back ( );
+    cnf.pop_back ( );
+    vars = formula.vars;
+  } else {
+    vars = 6 + rng ( ) % 7;
+    auto literal = [&] (const int range) { const int var = 1 + rng ( ) % range; return rng ( ) % 2 ? var : -var; };
+
+  /* Distinct inputs 'a', 'b', 'c' of the gate output 'x' */
+    const int x = rng ( ) % 2 ? vars : -vars;
+    int a = literal (vars - 1), b = literal (vars - 1), c = literal (vars - 1);
+    while (abs (b) == abs (a)) b = literal (vars - 1);
+    while (abs (c) == abs (a) || abs (c) == abs (b)) c = literal (vars - 1);
+    const bool three = rng ( ) % 2;
+    if (kind == 0) {                                        // x = a & b (& c)
+      cnf.push_back ({ -x, a }), cnf.push_back ({ -x, b });
+      if (three) cnf.push_back ({ -x, c }), cnf.push_back ({ x, -a, -b, -c });
+      else cnf.push_back ({ x, -a, -b });
+    } else if (kind == 1) {                                 // x = c ? a : b
+      cnf.push_back ({ -x, -c, a }), cnf.push_back ({ -x, c, b });
+      cnf.push_back ({ x, -c, -a }), cnf.push_back ({ x, c, -b });
+    } else {                                                // x = a ^ b (^ c)
+      const std::vector<int> lits = three ? std::vector<int> { x, a, b, c } : std::vector<int> { x, a, b };
+      for (uint32_t flip = 0; flip < 1u << lits.size ( ); ++flip) {
+        if (!(__builtin_popcount (flip) & 1)) continue;
+        cnf.emplace_back ( );
+        for (size_t i = 0; i < lits.size ( ); ++i) cnf.back ( ).push_back (flip >> i & 1 ? -lits[i] : lits[i]);
+      }
+    }
+    for (int i = 0, n = rng ( ) % vars; i < n; ++i) {
+      cnf.emplace_back ( );
+      for (int j = 0, size = 2 + rng ( ) % 3; j < size; ++j) cnf.back ( ).push_back (literal (vars));
+    }
+    std::shuffle (cnf.begin ( ), cnf.end ( ), rng);
+  }
+
+  sat::CDCL cdcl;
+  for (const std::vector<int>& clause : cnf) cdcl.add_clause (clause);
+  Modes modes;
+  modes.elim = true, modes.block = false;
+  modes.subsume = rng ( ) % 2, modes.hash = rng ( ) % 2;
+  const int status = cdcl.simplify (modes);
+  gates += cdcl.stats.elim_gates;
+  return reconstruct_mismatch (cnf, vars, { }, cdcl, status);
+}
+
+/*-------------------------------------------------------------------------+
+ | Incremental simplification (see 'simplify_incremental') of a random     |
+ | formula over at most 12 variables added in four chunks. Each chunk is   |
+ | followed by a call with random assumptions, and before some calls the   |
+ | witness of a removed clause is frozen (which restores its clauses) or a |
+ | frozen variable is melted. After each call the result is checked by     |
+ | brute force against the formula so far (see 'reconstruct_mismatch'), and|
+ | so is simplifying that formula in one call. Clauses of later chunks     |
+ | reuse eliminated and substituted variables. Adds the restored clauses to|
+ | 'restored'.                                                             |
+/*-------------------------------------------------------------------------*/
+static std::string incremental_mismatch (const int seed, long& restored) {
+
+  std::mt19937_64 rng (seed);
+  const int vars = 6 + rng ( ) % 7;
+  auto literal = [&] ( ) { const int var = 1 + rng ( ) % vars; return rng ( ) % 2 ? var : -var; };
+  Modes modes;
+  modes.incremental = true;
+  modes.subsume = rng ( ) % 2, modes.block = rng ( ) % 2, modes.elim = rng ( ) % 2, modes.hash = rng ( ) % 2;
+  modes.substitute = rng ( ) % 2;
+  sat::CDCL cdcl;
+  CNF cnf;
+  std::vector<int> frozen;
+  for (int chunk = 0; chunk < 4; ++chunk) {
+    const std::string where = "chunk " + std::to_string (chunk) + ": ";
+
+  /* Clauses of two to four literals and equivalences */
+    for (int i = 0, n = 2 + rng ( ) % vars; i < n; ++i) {
+      if (rng ( ) % 4 == 0) {
+        const int a = literal ( ), b = literal ( );
+        if (abs (a) == abs (b)) continue;
+        cnf.push_back ({ -a, b }), cdcl.add_clause (cnf.back ( ));
+        cnf.push_back ({ a, -b }), cdcl.add_clause (cnf.back ( ));
+        continue;
+      }
+      cnf.emplace_back ( );
+      for (int j = 0, size = 2 + rng ( ) % 3; j < size; ++j) cnf.back ( ).push_back (literal ( ));
+      cdcl.add_clause (cnf.back ( ));
+    }
+
+  /* Assumptions, freezing a witness and melting */
+    std::vector<int> assumed;
+    for (int i = 0, n = rng ( ) % 3; i < n; ++i) assumed.push_back (literal ( )), cdcl.assume (assumed.back ( ));
+    const std::vector<int>& removed = cdcl.removed ( );
+    if (!removed.empty ( ) && rng ( ) % 2) {
+      const int witness = abs (removed[0]);
+      const long before = cdcl.stats.restored;
+      cdcl.freeze (witness);
+      frozen.push_back (witness);
+      restored += cdcl.stats.restored - before;
+      for (size_t i = 0; i < removed.size ( ); ++i) {
+        if (abs (removed[i]) == witness) return where + "removed clause with frozen witness " + std::to_string (witness);
+        while (removed[i]) ++i;
+      }
+    } else if (!frozen.empty ( ) && rng ( ) % 2) {
+      cdcl.melt (frozen.back ( ));
+      frozen.pop_back ( );
+    }
+
+  /* Incremental call and one call on the formula so far */
+    const int status = cdcl.simplify (modes);
+    restored += cdcl.stats.restored;
+    std::string failure = reconstruct_mismatch (cnf, vars, assumed, cdcl, status);
+    if (!failure.empty ( )) return where + failure;
+    sat::CDCL once;
+    for (const std::vector<int>& clause : cnf) once.add_clause (clause);
+    for (const int lit : assumed) once.assume (lit);
+    Modes single = modes;
+    single.incremental = false;
+    failure = reconstruct_mismatch (cnf, vars, assumed, once, once.simplify (single));
+    if (!failure.empty ( )) return where + "one call: " + failure;
+    if (status == 20) break;
+  }
+  return "";
+}
+
+int main (int argc, char** argv) {
+
+  const int instances = argc > 1 ? atoi (argv[1]) : 200;
+  const std::string dir = argc > 2 ? argv[2] : ".";
+  const char* families[] = { "ksat", "circuit", "redundant", "blocked" };
+  const char* techniques[] = { "subsume", "block", "elim", "all", "cover", "substitute" };
+
+  int failed = 0;
+  long substituted = 0;
+  const char* kinds[] = { "and", "ite", "xor", "circuit" };
+  long gates[4] = { };
+  long restored = 0;
+  for (int i = 0; i < instances; ++i) {
+
+  /* Small instances of all families, k-SAT at several densities */
+    const std::string family = families[i % 4];
+    const int size = 20 + (7 * i) % 400;
+    std::map<std::string, double> params;
+    if (family == "ksat") params["ratio"] = 2 + (i / 4) % 4;
+    sat::Formula formula;
+    sat::generate (family, size, i, params, formula);
+    CNF cnf (1);
+    for (const int lit : formula.lits)
+      if (lit) cnf.back ( ).push_back (lit);
+      else cnf.push_back ({ });
+    cnf.pop_back ( );
+
+  /* Tokenizer */
+    const std::string tier = tokenize_mismatch (formula.lits, i);
+    if (!tier.empty ( )) {
+      std::cout << "FAIL " << family << " " << size << " seed " << i << " tokenize: '" << tier << "' differs" << std::endl;
+      ++failed;
+    }
+
+  /* Signature kernel on full blocks */
+    const std::string signature_tier = signature_mismatch (i);
+    if (!signature_tier.empty ( )) {
+      std::cout << "FAIL seed " << i << " signature_mask: '" << signature_tier << "' differs" << std::endl;
+      ++failed;
+    }
+
+  /* Substitution against brute force */
+    const std::string substitute_failure = substitute_mismatch (i, substituted);
+    if (!substitute_failure.empty ( )) {
+      std::cout << "FAIL seed " << i << " substitute: " << substitute_failure << std::endl;
+      ++failed;
+    }
+
+  /* Gate definitions in BVE against brute force */
+    for (int k = 0; k < 4; ++k) {
+      const std::string gate_failure = gate_mismatch (i, k, gates[k]);
+      if (gate_failure.empty ( )) continue;
+      std::cout << "FAIL seed " << i << " " << kinds[k] << " gate: " << gate_failure << std::endl;
+      ++failed;
+    }
+
+  /* Incremental calls against brute force and one call */
+    const std::string incremental_failure = incremental_mismatch (i, restored);
+    if (!incremental_failure.empty ( )) {
+      std::cout << "FAIL seed " << i << " incremental: " << incremental_failure << std::endl;
+      ++failed;
+    }
+
+    for (int t = 0; t < 6; ++t) {
+      Modes modes;
+      modes.subsume    = t == 0 || t == 3 || t == 5;
+      modes.block      = t == 1 || t == 3 || t == 4 || t == 5;
+      modes.elim       = t == 2 || t == 3 || t == 5;
+      modes.cover      = t == 4;
+      modes.substitute = t == 5;
+      const size_t v = mismatch (cnf, modes);
+      if (!v) continue;
+
+    /* Minimize and save the formula */
+      const CNF small = minimize (cnf, modes, v);
+      const std::string name = dir + "/differential-" + family + "-" + std::to_string (i) + "-" + techniques[t] + ".cnf";
+      int vars = 0;
+      for (const std::vector<int>& clause : small)
+        for (const int lit : clause) vars = std::max (vars, abs (lit));
+      std::ofstream out (name);
+      out << "c " << techniques[t] << ": '" << variants[v].name << "' differs from '" << variants[0].name << "'\n";
+      out << "p cnf " << vars << " " << small.size ( ) << "\n";
+      for (const std::vector<int>& clause : small) {
+        for (const int lit : clause) out << lit << " ";
+        out << "0\n";
+      }
+      std::cout << "FAIL " << family << " " << size << " seed " << i << " " << techniques[t] << ": '"
+                << variants[v].name << "' differs from '" << variants[0].name << "', minimized to "
+                << small.size ( ) << " clauses in '" << name << "'" << std::endl;
+      print_diff (small, modes, v);
+      ++failed;
+    }
+  }
+
+/* Fixed substitution cases, and substitution has to happen at all */
+  const std::string substitute_failure = substitute_cases ( );
+  if (!substitute_failure.empty ( )) {
+    std::cout << "FAIL substitute: " << substitute_failure << std::endl;
+    ++failed;
+  }
+  if (instances && !substituted) {
+    std::cout << "FAIL substitute: no variable substituted" << std::endl;
+    ++failed;
+  }
+  for (int k = 0; instances && k < 4; ++k)
+    if (!gates[k]) {
+      std::cout << "FAIL " << kinds[k] << " gate: no gate found" << std::endl;
+      ++failed;
+    }
+  if (instances && !restored) {
+    std::cout << "FAIL incremental: no clause restored" << std::endl;
+    ++failed;
+  }
+  std::cout << failed << " mismatches in " << instances << " instances x " << variants.size ( ) << " variants" << std::endl;
+  return failed ? 1 : 0;
+}
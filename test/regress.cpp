@@ -0,0 +1,285 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+
+/*-------------------------------------------------------------------------+
+ | Performance regression test. Generated instances are simplified by each |
+ | technique with and without signatures, and the median time and the      |
+ | counters are compared with a checked-in baseline. Usage:                |
+ |   sat_regress <baseline>            compare (exit code 1 on regression) |
+ |   sat_regress <baseline> --counters compare the counters only (one run) |
+ |   sat_regress <baseline> --update   measure and write a new baseline    |
+ | Times are stored relative to a fixed calibration workload, so that the  |
+ | baseline carries over to other machines. A time regresses if its median |
+ | exceeds the baseline by more than 'SAT_REGRESS_TOLERANCE' (default 0.25)|
+ | plus three times the relative noise of both measurements and by more    |
+ | than 'absolute_floor', also when it is measured again. Counters have to |
+ | match exactly. The number of runs is 'SAT_REGRESS_RUNS' (default 7).    |
+/*-------------------------------------------------------------------------*/
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+/* User includes */
+#include "generate.h"
+#include "solver.h"
+
+/*-------------------------------------------------------------------------+
+ | Result of one configuration: median time (relative to calibration),     |
+ | relative noise (median absolute deviation / median) and counters.       |
+/*-------------------------------------------------------------------------*/
+struct Result {
+  std::string name;
+  double time  = 0;
+  double noise = 0;
+  std::vector<long> counters;
+  ~Result ( );                   // out of line, it is not worth inlining
+};
+
+Result::~Result ( ) { }
+
+static const char* counter_names[] = { "subsumed", "strengthened", "blocked", "eliminated", "clauses", "units" };
+
+/* Median and relative median absolute deviation of 'xs' */
+static double median (std::vector<double> xs) {
+
+  std::sort (xs.begin ( ), xs.end ( ));
+  const size_t n = xs.size ( );
+  return n % 2 ? xs[n / 2] : (xs[n / 2 - 1] + xs[n / 2]) / 2;
+}
+
+static double noise (const std::vector<double>& xs) {
+
+  const double m = median (xs);
+  std::vector<double> deviations;
+  for (const double x : xs) deviations.push_back (std::abs (x - m));
+  return m > 0 ? median (deviations) / m : 0;
+}
+
+template <class F>
+static std::vector<double> measure (const int runs, F run) {
+
+  std::vector<double> times;
+  for (int r = 0; r < runs; ++r) {
+    auto start = std::chrono::high_resolution_clock::now ( );
+    run ( );
+    auto end = std::chrono::high_resolution_clock::now ( );
+    times.push_back (std::chrono::duration<double>(end - start).count ( ));
+  }
+  return times;
+}
+
+/* Slowdowns below this (in calibration units) are noise on the short
+   configurations (e.g. 'php-40', a few milliseconds) */
+static const double absolute_floor = 0.05;
+
+/*-------------------------------------------------------------------------+
+ | Calibration workload: sort 2^20 random integers (seconds, median).      |
+/*-------------------------------------------------------------------------*/
+static double calibrate (const int runs) {
+
+  std::mt19937_64 rng (2021);
+  std::vector<uint64_t> xs (1 << 20);
+  for (uint64_t& x : xs) x = rng ( );
+  return median (measure (runs, [&] ( ) {
+    std::vector<uint64_t> ys = xs;
+    std::sort (ys.begin ( ), ys.end ( ));
+  }));
+}
+
+/*-------------------------------------------------------------------------+
+ | Configurations: every instance with every technique, with and without   |
+ | signatures.                                                             |
+/*-------------------------------------------------------------------------*/
+struct Config {
+  std::string name;
+  const sat::Formula* formula;
+  Modes modes;
+};
+
+static std::vector<Config> configurations (const std::vector<sat::Formula>& formulas, const std::vector<std::string>& names) {
+
+  const char* techniques[] = { "subsume", "block", "elim" };
+  std::vector<Config> configs;
+  for (size_t i = 0; i < formulas.size ( ); ++i)
+    for (int t = 0; t < 3; ++t)
+      for (const bool hash : { false, true }) {
+        Config config;
+        config.name = names[i] + "/" + techniques[t] + (hash ? "/hash" : "/plain");
+        config.formula = &formulas[i];
+        config.modes.subsume = t == 0;
+        config.modes.block   = t == 1;
+        config.modes.elim    = t == 2;
+        config.modes.hash    = hash;
+        configs.push_back (config);
+      }
+  return configs;
+}
+
+/*-------------------------------------------------------------------------+
+ | Simplify the formula of 'config' 'runs' times.                          |
+/*-------------------------------------------------------------------------*/
+static Result run (const Config& config, const int runs, const double unit) {
+
+  Result result;
+  result.name = config.name;
+  const std::vector<double> times = measure (runs, [&] ( ) {
+    sat::CDCL cdcl;
+    cdcl.add_clauses (config.formula->lits.data ( ), config.formula->lits.size ( ));
+    cdcl.simplify (config.modes);
+    const Clauses view = cdcl.clauses ( );
+    const long clauses = std::distance (view.begin ( ), view.end ( ));
+    result.counters = { cdcl.stats.subsumed, cdcl.stats.strengthened, cdcl.stats.block_clauses,
+                        cdcl.stats.eliminated, clauses, (long) cdcl.units ( ).size ( ) };
+  });
+  result.time = median (times) / unit;
+  result.noise = noise (times);
+  return result;
+}
+
+/*-------------------------------------------------------------------------+
+ | Baseline file: one line 'name time noise counters...' per configuration.|
+/*-------------------------------------------------------------------------*/
+static void write_baseline (const std::string& file_name, const std::vector<Result>& results) {
+
+  std::ofstream out (file_name);
+  out << "# Performance baseline of sat_regress (regenerate with 'sat_regress <file> --update').\n";
+  out << "# name, time (relative to calibration), noise";
+  for (const char* name : counter_names) out << ", " << name;
+  out << "\n";
+  for (const Result& r : results) {
+    out << r.name << " " << std::setprecision (4) << r.time << " " << r.noise;
+    for (const long x : r.counters) out << " " << x;
+    out << "\n";
+  }
+}
+
+static bool read_baseline (const std::string& file_name, std::map<std::string, Result>& results) {
+
+  std::ifstream in (file_name);
+  if (!in) return false;
+  std::string line;
+  while (std::getline (in, line)) {
+    if (line.empty ( ) || line[0] == '#') continue;
+    std::istringstream stream (line);
+    Result r;
+    long x;
+    stream >> r.name >> r.time >> r.noise;
+    while (stream >> x) r.counters.push_back (x);
+    results[r.name] = r;
+  }
+  return true;
+}
+
+int main (int argc, char** argv) {
+
+  if (argc < 2) {
+    std::cerr << "usage: sat_regress <baseline> [--update | --counters]" << std::endl;
+    return 2;
+  }
+  const std::string file_name = argv[1];
+  const bool update = argc > 2 && std::string (argv[2]) == "--update";
+  const bool counters = argc > 2 && std::string (argv[2]) == "--counters";
+  const bool timed = !SAT_PROFILE && !counters;
+  const char* env_runs = getenv ("SAT_REGRESS_RUNS");
+  const char* env_tolerance = getenv ("SAT_REGRESS_TOLERANCE");
+  const int runs = counters ? 1 : std::max (3, env_runs ? atoi (env_runs) : 7);
+  const double tolerance = env_tolerance ? atof (env_tolerance) : 0.25;
+  const std::vector<std::pair<std::string, int>> instances = {
+    { "ksat", 20000 }, { "circuit", 20000 }, { "php", 40 }, { "redundant", 20000 }, { "blocked", 20000 } };
+
+/* Generate instances */
+  std::vector<sat::Formula> formulas;
+  std::vector<std::string> names;
+  for (const auto& instance : instances) {
+    formulas.push_back (sat::Formula ( ));
+    sat::generate (instance.first, instance.second, 2021, { }, formulas.back ( ));
+    names.push_back (instance.first + "-" + std::to_string (instance.second));
+  }
+  const std::vector<Config> configs = configurations (formulas, names);
+
+/* Measure. The baseline takes the median of three passes (each calibrated
+   separately), and the spread between the passes counts as noise as well. */
+  std::vector<Result> results;
+  const double unit = calibrate (runs);
+  for (const Config& config : configs) results.push_back (run (config, runs, unit));
+  if (update) {
+    std::vector<std::vector<Result>> passes = { results };
+    for (int pass = 1; pass < 3; ++pass) {
+      const double unit = calibrate (runs);
+      passes.push_back ({ });
+      for (const Config& config : configs) passes.back ( ).push_back (run (config, runs, unit));
+    }
+    for (size_t i = 0; i < configs.size ( ); ++i) {
+      std::vector<double> times;
+      for (const std::vector<Result>& pass : passes) {
+        times.push_back (pass[i].time);
+        results[i].noise = std::max (results[i].noise, pass[i].noise);
+      }
+      results[i].time = median (times);
+      results[i].noise = std::max (results[i].noise, noise (times));
+    }
+    write_baseline (file_name, results);
+    std::cout << "wrote " << results.size ( ) << " configurations to '" << file_name << "'" << std::endl;
+    return 0;
+  }
+
+/* Compare with the baseline. A configuration that seems slower is measured
+   again (twice as often, after calibrating again) to rule out noise. */
+  std::map<std::string, Result> baseline;
+  if (!read_baseline (file_name, baseline)) {
+    std::cerr << "could not read baseline '" << file_name << "'" << std::endl;
+    return 2;
+  }
+  if (SAT_PROFILE) std::cout << "profiling build: only counters are compared" << std::endl;
+  else if (counters) std::cout << "only counters are compared" << std::endl;
+  int failed = 0;
+  for (size_t i = 0; i < configs.size ( ); ++i) {
+    Result& r = results[i];
+    const auto it = baseline.find (r.name);
+    if (it == baseline.end ( )) { std::cout << "  new  " << r.name << " (not in baseline)" << std::endl; continue; }
+    const Result& b = it->second;
+    std::vector<std::string> diffs;
+    for (size_t j = 0; j < r.counters.size ( ); ++j) {
+      const long expected = j < b.counters.size ( ) ? b.counters[j] : -1;
+      if (r.counters[j] != expected)
+        diffs.push_back (std::string (counter_names[j]) + " " + std::to_string (expected) + " -> " + std::to_string (r.counters[j]));
+    }
+    auto limit = [&] ( ) { return tolerance + 3 * std::max (r.noise, b.noise); };
+    auto slower = [&] ( ) { return r.time / b.time - 1 > limit ( ) && r.time - b.time > absolute_floor; };
+    if (timed && slower ( )) {
+      const Result again = run (configs[i], 2 * runs, calibrate (runs));
+      if (again.time < r.time) r = again;
+    }
+    std::ostringstream time;
+    time << std::fixed << std::setprecision (4) << "time " << b.time << " -> " << r.time << " ("
+         << std::showpos << std::setprecision (1) << 100 * (r.time / b.time - 1) << "%, limit "
+         << 100 * limit ( ) << "%)";
+    const bool regressed = timed && slower ( );
+    if (regressed) time << "  SLOWER";
+    std::cout << (diffs.empty ( ) && !regressed ? "  ok   " : "  FAIL ") << r.name << (timed ? "  " + time.str ( ) : "") << std::endl;
+    for (const std::string& diff : diffs) std::cout << "         " << diff << std::endl;
+    failed += !diffs.empty ( ) || regressed;
+  }
+  std::cout << failed << " of " << results.size ( ) << " configurations regressed" << std::endl;
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,207 @@
+/*-------------------------------------------------------------------------+
+ | Copyright (c) 2020, Henrik Cao, henrik.cao@aalto.fi, Espoo, Finland.    |
+ |                                                                         |
+ | Permission is hereby granted, free of charge, to any person obtaining a |
+ | copy of this software and associated documentation files, to deal in the|
+ | Software without restriction, including without limitation the rights to|
+ | use, copy, modify, merge, publish, distribute, sublicense, and/or sell  |
+ | copies of the Software, and to permit persons to whom the Software is   |
+ | furnished to do so, subject to the following conditions:                |
+ |                                                                         |
+ | The above copyright notice and this permission notice shall be included |
+ | in all copies or substantial portions of the Software.                  |
+ |                                                                         |
+ | THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS |
+ | OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABI- |
+ | LITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT |
+ | SHALL THE AUTHORS OR COPYRIGHT HOLDERS BELIABLE FOR ANY CLAIM, DAMAGES  |
+ | OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,|
+ | ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR   |
+ | OTHER DEALINGS IN THE SOFTWARE.                                         |
+/*-------------------------------------------------------------------------*/
+
+/*-------------------------------------------------------------------------+
+ | Test of the preprocessing service (see 'server.h'). Small formulas, some|
+ | of them inconsistent (also by an empty clause), are sent as 'cnf' and   |
+ | 'file' requests to a server without a cache and to one with a cache, to |
+ | which every request is sent twice. As the cache is content addressed,   |
+ | only the first request of a formula misses. The status has to match     |
+ | simplifying the formula directly and the returned formula has to be     |
+ | equisatisfiable with the input, which is checked by brute force.        |
+ | Usage: sat_server [directory]                                           |
+/*-------------------------------------------------------------------------*/
+#include <filesystem>
+#include <fstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/* User includes */
+#include "server.h"
+
+typedef std::vector<std::vector<int>> CNF;
+
+/*-------------------------------------------------------------------------+
+ | Send 'request' (and 'payload') to the server at 'path' and return the   |
+ | answer. Retries while the server does not listen yet.                   |
+/*-------------------------------------------------------------------------*/
+static std::string ask (const std::string& path, const std::string& request, const std::string& payload) {
+
+  sockaddr_un addr;
+  memset (&addr, 0, sizeof addr);
+  addr.sun_family = AF_UNIX;
+  strncpy (addr.sun_path, path.c_str ( ), sizeof addr.sun_path - 1);
+  int fd = -1;
+  for (int attempt = 0; attempt < 200; ++attempt) {
+    fd = socket (AF_UNIX, SOCK_STREAM, 0);
+    if (!connect (fd, (sockaddr*) &addr, sizeof addr)) break;
+    close (fd);
+    fd = -1;
+    std::this_thread::sleep_for (std::chrono::milliseconds (10));
+  }
+  if (fd < 0) return "";
+  const std::string data = request + "\n" + payload;
+  for (size_t done = 0; done < data.size ( ); ) {
+    const ssize_t n = send (fd, data.data ( ) + done, data.size ( ) - done, MSG_NOSIGNAL);
+    if (n <= 0) break;
+    done += n;
+  }
+  shutdown (fd, SHUT_WR);
+  std::string answer;
+  char chunk[4096];
+  for (ssize_t n; (n = recv (fd, chunk, sizeof chunk, 0)) > 0; ) answer.append (chunk, n);
+  close (fd);
+  return answer;
+}
+
+/*-------------------------------------------------------------------------+
+ | Satisfiability of 'cnf' over 'vars' variables by trying all assignments.|
+/*-------------------------------------------------------------------------*/
+static bool satisfiable (const CNF& cnf, const int vars) {
+
+  for (uint32_t assignment = 0; assignment < (1u << vars); ++assignment) {
+    bool all = true;
+    for (size_t i = 0; all && i < cnf.size ( ); ++i) {
+      bool any = false;
+      for (const int lit : cnf[i])
+        any = any || (lit > 0) == ((assignment >> (abs (lit) - 1)) & 1);
+      all = any;
+    }
+    if (all) return true;
+  }
+  return false;
+}
+
+/*-------------------------------------------------------------------------+
+ | Parse the status and the formula of an answer with 'output'. Returns    |
+ | false if the answer is not complete.                                    |
+/*-------------------------------------------------------------------------*/
+static bool parse_answer (const std::string& answer, int& status, std::string& cache, CNF& cnf) {
+
+  std::istringstream lines (answer);
+  bool formula = false, end = false;
+  for (std::string line; std::getline (lines, line); ) {
+    if (line == "end") { end = true; break; }
+    if (line.rfind ("s ", 0) == 0) status = atoi (line.c_str ( ) + 2);
+    else if (line.rfind ("cache ", 0) == 0) cache = line.substr (6);
+    else if (line.rfind ("p cnf", 0) == 0) formula = true;
+    else if (formula) {
+      std::istringstream clause (line);
+      cnf.push_back ({ });
+      for (int lit; clause >> lit && lit; ) cnf.back ( ).push_back (lit);
+    }
+  }
+  return end && formula;
+}
+
+/*-------------------------------------------------------------------------+
+ | Check the answers of the server at 'path' to the formula 'text' with    |
+ | 'flags' (as 'cnf' and as 'file' request). With a cache each request is  |
+ | sent twice and only the very first one may miss. Returns the number of  |
+ | failures.                                                               |
+/*-------------------------------------------------------------------------*/
+static int check (const std::string& path, const std::string& file, const std::string& text, const std::string& flags,
+                  const bool cached) {
+
+/* Expected status and satisfiability */
+  Modes modes;
+  modes.block = false;
+  std::istringstream words (flags);
+  for (std::string flag; words >> flag; ) {
+    if      (flag == "subsume") modes.subsume = true;
+    else if (flag == "block")   modes.block   = true;
+    else if (flag == "elim")    modes.elim    = true;
+    else if (flag == "substitute") modes.substitute = true;
+  }
+  sat::CDCL cdcl;
+  if (!cdcl.parse_dimacs (text.data ( ), text.data ( ) + text.size ( ))) {
+    std::cout << "FAIL could not parse '" << text << "'" << std::endl;
+    return 1;
+  }
+  const int vars = cdcl.param.vars;
+  CNF input (1);
+  std::istringstream body (text.substr (text.find ('\n') + 1));
+  for (int lit; body >> lit; )
+    if (lit) input.back ( ).push_back (lit);
+    else input.push_back ({ });
+  input.pop_back ( );
+  const int expected = cdcl.simplify (modes);
+  const bool sat = satisfiable (input, vars);
+
+  int failed = 0, sent = 0;
+  std::ofstream (file) << text;
+  const std::string requests[] = { "cnf " + std::to_string (text.size ( )) + " " + flags + " output",
+                                   "file " + file + " " + flags + " output" };
+  for (const std::string& request : requests)
+    for (int round = 0; round < (cached ? 2 : 1); ++round) {
+      const std::string answer = ask (path, request, request[0] == 'c' ? text : "");
+      int status = -1;
+      std::string cache;
+      CNF output;
+      const bool complete = parse_answer (answer, status, cache, output);
+      const std::string expected_cache = sent++ ? "hit" : "miss";
+      std::string error;
+      if      (!complete)                                        error = "incomplete answer";
+      else if (status != expected)                               error = "status " + std::to_string (status);
+      else if (cached && cache != expected_cache)                error = "cache " + cache;
+      else if (satisfiable (output, vars) != sat)                error = "formula not equisatisfiable";
+      if (error.empty ( )) continue;
+      std::cout << "FAIL '" << request << "'" << (cached ? " (cached)" : "") << ": " << error << " on" << std::endl
+                << text << answer;
+      ++failed;
+    }
+  return failed;
+}
+
+int main (int argc, char** argv) {
+
+  const std::string dir = argc > 1 ? argv[1] : ".";
+  const std::string path = dir + "/sat_server.sock";
+  const std::string cache_dir = dir + "/sat_server.cache";
+  std::filesystem::remove_all (cache_dir);
+
+  const char* formulas[] = {
+    "p cnf 3 3\n1 2 0\n-1 3 0\n-2 -3 0\n",
+    "p cnf 2 3\n1 2 0\n0\n-1 2 0\n",                        // empty clause
+    "p cnf 2 2\n1 0\n-1 0\n",                               // inconsistent units
+    "p cnf 2 4\n1 2 0\n-1 2 0\n1 -2 0\n-1 -2 0\n",          // unsatisfiable
+    "p cnf 4 5\n1 -2 0\n2 -3 0\n3 -1 0\n1 4 0\n-4 -1 2 0\n" };
+  const char* flags[] = { "", "subsume block elim", "substitute subsume" };
+
+  int failed = 0, checks = 0;
+  for (const bool cached : { false, true }) {
+    sat::Server server (path, 2, cached ? sat::Cache (cache_dir, 0) : sat::Cache ( ));
+    std::thread daemon ([&server] ( ) { server.run ( ); });
+    for (const char* formula : formulas)
+      for (const char* flag : flags) {
+        failed += check (path, dir + "/sat_server.cnf", formula, flag, cached);
+        ++checks;
+      }
+    ask (path, "shutdown", "");
+    daemon.join ( );
+  }
+  std::filesystem::remove_all (cache_dir);
+  std::remove ((dir + "/sat_server.cnf").c_str ( ));
+  std::cout << failed << " failures in " << checks << " checks" << std::endl;
+  return failed ? 1 : 0;
+}